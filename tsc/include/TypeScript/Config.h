@@ -51,6 +51,16 @@
 //#define ENABLE_DEBUGINFO_PATCH_INFO true
 
 #define ENABLE_JS_BUILTIN_TYPES true
+
+// switch with constant cases is compiled into table (integers) or hash (strings) dispatch
+#define SWITCH_DISPATCH_MIN_CASES 3
+#define SWITCH_HASH_DISPATCH_MIN_CASES 4
+
+// initial capacity of buffer for strings accumulated in loops
+#define STRING_BUILDER_MIN_CAPACITY 64
+
+// equality with string literal up to this length is compared inline (type guards, tags), longer ones call strcmp
+#define STRING_COMPARE_INLINE_MAX_LENGTH 16
 #define NO_DEFAULT_LIB true
 
 // seems we can't use appending logic at all
@@ -5,6 +5,7 @@
 #define VIRTUALFUNC_ATTR_NAME "__virt"
 #define GENERIC_ATTR_NAME "__generic"
 #define INSTANCES_COUNT_ATTR_NAME "InstancesCount"
+#define REUSE_STACK_SLOT_ATTR_NAME "__reuse_slot"
 #define RETURN_VARIABLE_NAME ".return"
 #define CAPTURED_NAME ".captured"
 #define LABEL_ATTR_NAME "label"
@@ -50,6 +51,8 @@
 #define SYMBOL_DISPOSE "dispose"
 
 #define SHARED_LIB_DECLARATIONS "__decls"
+#define SHARED_LIB_DECLARATIONS_MANIFEST "__decls_manifest"
+#define SHARED_LIB_DECLARATIONS_MANIFEST_SIZE "__decls_manifest_size"
 #define DLL_EXPORT "dllexport"
 #define DLL_IMPORT "dllimport"
 
@@ -20,6 +20,9 @@ namespace mlir_ts = mlir::typescript;
 namespace typescript
 {
 
+// Value of any is box { size, typeof, value } in heap. On 64-bit targets number, boolean and i32 values are kept in the
+// pointer itself (NaN-boxing), so boxing them does not allocate: pointers to boxes have top 16 bits 0, number is its
+// bits + 2^49 (top 16 bits are 0x0002..0xFFFA, NaN is canonical), boolean and i32 are tagged by top 16 bits
 class AnyLogic
 {
     Operation *op;
@@ -34,6 +37,13 @@ class AnyLogic
     mlir::Type indexType;
     mlir::Type llvmIndexType;
     mlir::Type valuePtrType;
+    bool immediateValues;
+
+    static constexpr uint64_t NUMBER_OFFSET = 1ULL << 49;
+    static constexpr uint64_t CANONICAL_NAN = 0x7FF8000000000000ULL;
+    static constexpr int TAG_SHIFT = 48;
+    static constexpr uint64_t BOOLEAN_TAG = 0xFFFE;
+    static constexpr uint64_t I32_TAG = 0xFFFF;
 
   public:
     AnyLogic(Operation *op, PatternRewriter &rewriter, TypeConverterHelper &tch, Location loc, CompileOptions &compileOptions)
@@ -42,6 +52,7 @@ class AnyLogic
         indexType = th.getIndexType();
         llvmIndexType = tch.convertType(indexType);
         valuePtrType = th.getI8PtrType();
+        immediateValues = !compileOptions.isWasm && llvmIndexType.getIntOrFloatBitWidth() == 64;
     }
 
     LLVM::LLVMStructType getStorageType(mlir::Type llvmStorageType)
@@ -58,14 +69,21 @@ class AnyLogic
         return castToAny(in, typeOfValue, inLLVMType);
     }
 
-    mlir::Value castToAny(mlir::Value in, mlir::Value typeOfValue, mlir::Type inLLVMType)
+    // typeOfName is known when type of value is known at compile time (not a union)
+    mlir::Value castToAny(mlir::Value in, mlir::Value typeOfValue, mlir::Type inLLVMType,
+                          std::optional<StringRef> typeOfName = std::nullopt)
     {
+        if (typeOfName && isImmediate(typeOfName.value(), inLLVMType))
+        {
+            return encodeImmediate(in, inLLVMType);
+        }
+
         // TODO: add type id to track data type
         auto llvmStorageType = inLLVMType;
         auto dataWithSizeType = getStorageType(llvmStorageType);
         auto dataWithSizeTypePtr = LLVM::LLVMPointerType::get(dataWithSizeType);
 
-        auto memValue = ch.MemoryAllocBitcast(dataWithSizeTypePtr, dataWithSizeType);
+        auto memValue = ch.MemoryAllocBitcast(dataWithSizeTypePtr, dataWithSizeType, ch.getMemoryAllocSet(dataWithSizeType));
 
         // set value size
         auto sizeMLIR = rewriter.create<mlir_ts::SizeOfOp>(loc, indexType, llvmStorageType);
@@ -89,6 +107,104 @@ class AnyLogic
     }
 
     mlir::Value UnboxAny(mlir::Value in, mlir::Type resLLVMType)
+    {
+        if (immediateValues && isImmediateType(resLLVMType))
+        {
+            auto bits = rewriter.create<LLVM::PtrToIntOp>(loc, th.getI64Type(), in);
+            return clh.conditionalExpressionLowering(
+                loc, resLLVMType, isBox(bits),
+                [&](OpBuilder &builder, Location loc) { return loadFromBox(in, resLLVMType); },
+                [&](OpBuilder &builder, Location loc) { return decodeImmediate(bits, resLLVMType); });
+        }
+
+        return loadFromBox(in, resLLVMType);
+    }
+
+    mlir::Value getTypeOfAny(mlir::Value in)
+    {
+        if (immediateValues)
+        {
+            auto bits = rewriter.create<LLVM::PtrToIntOp>(loc, th.getI64Type(), in);
+            return clh.conditionalExpressionLowering(
+                loc, th.getI8PtrType(), isBox(bits),
+                [&](OpBuilder &builder, Location loc) { return loadTypeOfFromBox(in); },
+                [&](OpBuilder &builder, Location loc) {
+                    auto tag = getTag(bits);
+                    auto isBoolean = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, tag,
+                                                                   clh.createI64ConstantOf(BOOLEAN_TAG));
+                    auto isI32 = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, tag,
+                                                               clh.createI64ConstantOf(I32_TAG));
+                    auto tagged = rewriter.create<LLVM::OrOp>(loc, isBoolean, isI32);
+                    auto taggedTypeOf = rewriter.create<LLVM::SelectOp>(
+                        loc, isBoolean, ch.getOrCreateGlobalString(std::string("boolean")),
+                        ch.getOrCreateGlobalString(std::string("i32")));
+                    return rewriter.create<LLVM::SelectOp>(loc, tagged, taggedTypeOf,
+                                                           ch.getOrCreateGlobalString(std::string("number")));
+                });
+        }
+
+        return loadTypeOfFromBox(in);
+    }
+
+  private:
+    bool isImmediateType(mlir::Type llvmType)
+    {
+        return llvmType.isF64() || llvmType.isInteger(1) || llvmType.isInteger(32);
+    }
+
+    bool isImmediate(StringRef typeOfName, mlir::Type llvmType)
+    {
+        return immediateValues && ((typeOfName == "number" && llvmType.isF64()) ||
+                                   (typeOfName == "boolean" && llvmType.isInteger(1)) ||
+                                   (typeOfName == "i32" && llvmType.isInteger(32)));
+    }
+
+    mlir::Value getTag(mlir::Value bits)
+    {
+        return rewriter.create<LLVM::LShrOp>(loc, bits, clh.createI64ConstantOf(TAG_SHIFT));
+    }
+
+    mlir::Value isBox(mlir::Value bits)
+    {
+        return rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, getTag(bits), clh.createI64ConstantOf(0));
+    }
+
+    mlir::Value encodeImmediate(mlir::Value in, mlir::Type llvmType)
+    {
+        auto i64Type = th.getI64Type();
+        mlir::Value bits;
+        if (llvmType.isF64())
+        {
+            // all NaNs are one value, so encoded value does not overflow into range of pointers
+            auto valueBits = rewriter.create<LLVM::BitcastOp>(loc, i64Type, in);
+            auto isNaN = rewriter.create<LLVM::FCmpOp>(loc, th.getLLVMBoolType(), LLVM::FCmpPredicate::uno, in, in);
+            auto canonicalBits =
+                rewriter.create<LLVM::SelectOp>(loc, isNaN, clh.createI64ConstantOf(CANONICAL_NAN), valueBits);
+            bits = rewriter.create<LLVM::AddOp>(loc, i64Type, canonicalBits, clh.createI64ConstantOf(NUMBER_OFFSET));
+        }
+        else
+        {
+            auto tag = llvmType.isInteger(1) ? BOOLEAN_TAG : I32_TAG;
+            auto payload = rewriter.create<LLVM::ZExtOp>(loc, i64Type, in);
+            bits = rewriter.create<LLVM::OrOp>(loc, i64Type, payload, clh.createI64ConstantOf(tag << TAG_SHIFT));
+        }
+
+        return rewriter.create<LLVM::IntToPtrOp>(loc, valuePtrType, bits);
+    }
+
+    mlir::Value decodeImmediate(mlir::Value bits, mlir::Type llvmType)
+    {
+        if (llvmType.isF64())
+        {
+            auto valueBits =
+                rewriter.create<LLVM::SubOp>(loc, th.getI64Type(), bits, clh.createI64ConstantOf(NUMBER_OFFSET));
+            return rewriter.create<LLVM::BitcastOp>(loc, llvmType, valueBits);
+        }
+
+        return rewriter.create<LLVM::TruncOp>(loc, llvmType, bits);
+    }
+
+    mlir::Value loadFromBox(mlir::Value in, mlir::Type resLLVMType)
     {
         // TODO: add type id to track data type
         // TODO: add data size check
@@ -108,7 +224,7 @@ class AnyLogic
         return rewriter.create<LLVM::LoadOp>(loc, ptrValue);
     }
 
-    mlir::Value getTypeOfAny(mlir::Value in)
+    mlir::Value loadTypeOfFromBox(mlir::Value in)
     {
         // TODO: add type id to track data type
         // TODO: add data size check
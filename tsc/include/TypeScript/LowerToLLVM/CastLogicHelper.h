@@ -149,6 +149,18 @@ class CastLogicHelper
 
         if (isInString && (resLLVMType.isF32() || resLLVMType.isF64()))
         {
+            ConvertLogic cl(op, rewriter, tch, loc, compileOptions);
+            if (cl.isRuntimeAvailable())
+            {
+                auto numberValue = cl.stringToNumber(in);
+                if (resLLVMType.isF32())
+                {
+                    return rewriter.create<LLVM::FPTruncOp>(loc, resLLVMType, numberValue);
+                }
+
+                return numberValue;
+            }
+
             auto castNumberOp = rewriter.create<mlir_ts::ParseFloatOp>(loc, resType, in);
             return rewriter.create<mlir_ts::DialectCastOp>(loc, resLLVMType, castNumberOp);
         }
@@ -782,8 +794,8 @@ class CastLogicHelper
     {
         mlir::Value valueAsLLVMType = rewriter.create<mlir_ts::DialectCastOp>(loc, tch.convertType(in.getType()), in);
 
-        return rewriter.create<LLVM::SelectOp>(loc, valueAsLLVMType, ch.getOrCreateGlobalString("__true__", std::string("true")),
-                                               ch.getOrCreateGlobalString("__false__", std::string("false")));
+        return rewriter.create<LLVM::SelectOp>(loc, valueAsLLVMType, ch.getOrCreateGlobalString(std::string("true")),
+                                               ch.getOrCreateGlobalString(std::string("false")));
     }
 
     mlir::Value castBoolToNumber(mlir::Value in)
@@ -897,7 +909,7 @@ class CastLogicHelper
             auto bytesSize = rewriter.create<mlir_ts::SizeOfOp>(loc, th.getIndexType(), arrayValueSize);
             // TODO: create MemRef which will store information about memory. stack of heap, to use in array push to realloc
             // auto copyAllocated = rewriter.create<LLVM::AllocaOp>(loc, arrayPtrType, bytesSize);
-            auto copyAllocated = ch.MemoryAllocBitcast(arrayPtrType, bytesSize);
+            auto copyAllocated = ch.MemoryAllocBitcast(arrayPtrType, bytesSize, ch.getMemoryAllocSet(arrayValueSize));
 
             auto ptrToArraySrc = rewriter.create<LLVM::BitcastOp>(loc, ptrToArray, in);
             auto ptrToArrayDst = rewriter.create<LLVM::BitcastOp>(loc, ptrToArray, copyAllocated);
@@ -28,13 +28,15 @@ class ConvertLogic
     LLVMCodeHelperBase ch;
     CodeLogicHelper clh;
     Location loc;
+    CompileOptions &compileOptions;
 
   protected:
     mlir::Type typeOfValueType;
 
   public:
     ConvertLogic(Operation *op, PatternRewriter &rewriter, TypeConverterHelper &tch, Location loc, CompileOptions &compileOptions)
-        : op(op), rewriter(rewriter), tch(tch), th(rewriter), ch(op, rewriter, &tch.typeConverter, compileOptions), clh(op, rewriter), loc(loc)
+        : op(op), rewriter(rewriter), tch(tch), th(rewriter), ch(op, rewriter, &tch.typeConverter, compileOptions), clh(op, rewriter), loc(loc),
+          compileOptions(compileOptions)
     {
         typeOfValueType = th.getI8PtrType();
     }
@@ -138,8 +140,44 @@ class ConvertLogic
         return sprintf(50, "%llu", value);
     }
 
+    // runtime library is linked to executable and loaded by JIT together with GC
+    bool isRuntimeAvailable()
+    {
+        return !compileOptions.isWasm && !(compileOptions.isJit && compileOptions.disableGC);
+    }
+
+    // ts_*_to_string(value, buffer) from runtime library, buffer of 32 bytes is enough for any number
+    mlir::Value runtimeToString(StringRef name, mlir::Value valueAsLLVMType)
+    {
+        auto i8PtrTy = th.getI8PtrType();
+
+        auto toStringFuncOp = ch.getOrInsertFunction(name, th.getFunctionType(i8PtrTy, {valueAsLLVMType.getType(), i8PtrTy}));
+
+        auto bufferSizeValue = clh.createI32ConstantOf(32);
+        auto newStringValue = ch.MemoryAllocBitcast(i8PtrTy, bufferSizeValue, MemoryAllocSet::Atomic);
+
+        return rewriter.create<LLVM::CallOp>(loc, toStringFuncOp, ValueRange{valueAsLLVMType, newStringValue}).getResult();
+    }
+
+    // ECMAScript ToNumber applied to String from runtime library
+    mlir::Value stringToNumber(mlir::Value value)
+    {
+        auto i8PtrTy = th.getI8PtrType();
+
+        auto toNumberFuncOp = ch.getOrInsertFunction("ts_string_to_number", th.getFunctionType(rewriter.getF64Type(), {i8PtrTy}));
+
+        mlir::Value valueAsLLVMType = rewriter.create<mlir_ts::DialectCastOp>(loc, i8PtrTy, value);
+        return rewriter.create<LLVM::CallOp>(loc, toNumberFuncOp, ValueRange{valueAsLLVMType}).getResult();
+    }
+
     mlir::Value intToString(mlir::Value value)
     {
+        if (isRuntimeAvailable())
+        {
+            mlir::Value valueAsLLVMType = rewriter.create<mlir_ts::DialectCastOp>(loc, tch.convertType(value.getType()), value);
+            return runtimeToString("ts_int32_to_string", valueAsLLVMType);
+        }
+
 #ifndef USE_SPRINTF
         return itoa(value);
 #else
@@ -149,6 +187,13 @@ class ConvertLogic
 
     mlir::Value int64ToString(mlir::Value value)
     {
+        if (isRuntimeAvailable())
+        {
+            mlir::Value valueAsLLVMType = rewriter.create<mlir_ts::DialectCastOp>(loc, tch.convertType(value.getType()), value);
+            return runtimeToString(value.getType().isUnsignedInteger() ? "ts_uint64_to_string" : "ts_int64_to_string",
+                                   valueAsLLVMType);
+        }
+
 #ifndef USE_SPRINTF
         return i64toa(value);
 #else
@@ -156,8 +201,20 @@ class ConvertLogic
 #endif
     }
 
+    // shortest representation which reads back as the same number (ECMAScript Number::toString)
     mlir::Value f32OrF64ToString(mlir::Value value)
     {
+        if (isRuntimeAvailable())
+        {
+            mlir::Value valueAsLLVMType = rewriter.create<mlir_ts::DialectCastOp>(loc, tch.convertType(value.getType()), value);
+            if (!valueAsLLVMType.getType().isF64())
+            {
+                valueAsLLVMType = rewriter.create<LLVM::FPExtOp>(loc, rewriter.getF64Type(), valueAsLLVMType);
+            }
+
+            return runtimeToString("ts_number_to_string", valueAsLLVMType);
+        }
+
 #ifndef USE_SPRINTF
         return gcvt(value);
 #else
@@ -16,7 +16,8 @@ enum class MemoryAllocSet
 {
     None,
     Zero,
-    Atomic
+    Atomic,
+    AtomicZero
 };
 
 template <typename T>
@@ -145,9 +146,22 @@ class LLVMCodeHelperBase
 
         auto llvmIndexType = tch.convertType(th.getIndexType());
 
-        // Create the global at the entry of the module.
+        // names are hashes of values, so one global per value; other value with the same hash gets next free name
         LLVM::GlobalOp global;
-        if (!(global = parentModule.lookupSymbol<LLVM::GlobalOp>(name)))
+        std::string uniqueName = name.str();
+        for (auto index = 1; (global = parentModule.lookupSymbol<LLVM::GlobalOp>(uniqueName)); index++)
+        {
+            auto valueAttr = global.getValueAttr().dyn_cast_or_null<StringAttr>();
+            if (valueAttr && valueAttr.getValue() == value)
+            {
+                break;
+            }
+
+            uniqueName = (name + "_" + Twine(index)).str();
+        }
+
+        // Create the global at the entry of the module.
+        if (!global)
         {
             OpBuilder::InsertionGuard insertGuard(rewriter);
             rewriter.setInsertionPointToStart(parentModule.getBody());
@@ -155,7 +169,9 @@ class LLVMCodeHelperBase
             seekLast<StringAttr>(parentModule.getBody());
 
             auto type = th.getArrayType(th.getI8Type(), value.size());
-            global = rewriter.create<LLVM::GlobalOp>(loc, type, true, LLVM::Linkage::Internal, name, rewriter.getStringAttr(value));
+            global = rewriter.create<LLVM::GlobalOp>(loc, type, true, LLVM::Linkage::Internal, uniqueName, rewriter.getStringAttr(value));
+            // address is not significant, equal constants can be merged
+            global.setUnnamedAddr(LLVM::UnnamedAddr::Global);
         }
 
         // Get the pointer to the first character in the global string.
@@ -211,6 +227,45 @@ class LLVMCodeHelperBase
         return MemoryAlloc(sizeOfTypeValue, zero);
     }
 
+    // stack memory is not zeroed as memory from allocator
+    void MemoryZero(mlir::Value ptrValue, mlir::Type storageType)
+    {
+        TypeHelper th(rewriter);
+        TypeConverterHelper tch(typeConverter);
+        CodeLogicHelper clh(op, rewriter);
+
+        auto llvmIndexType = tch.convertType(th.getIndexType());
+
+        auto loc = op->getLoc();
+
+        auto i8PtrTy = th.getI8PtrType();
+
+        auto effectivePtrValue = ptrValue;
+        if (ptrValue.getType() != i8PtrTy)
+        {
+            effectivePtrValue = rewriter.create<LLVM::BitcastOp>(loc, i8PtrTy, ptrValue);
+        }
+
+        auto sizeOfTypeValueMLIR = rewriter.create<mlir_ts::SizeOfOp>(loc, th.getIndexType(), storageType);
+        auto sizeOfTypeValue = rewriter.create<mlir_ts::DialectCastOp>(loc, llvmIndexType, sizeOfTypeValueMLIR);
+
+        auto memsetFuncOp = getOrInsertFunction("memset", th.getFunctionType(i8PtrTy, {i8PtrTy, th.getI32Type(), llvmIndexType}));
+        auto const0 = clh.createI32ConstantOf(0);
+        rewriter.create<LLVM::CallOp>(loc, memsetFuncOp, ValueRange{effectivePtrValue, const0, sizeOfTypeValue});
+    }
+
+    // allocation of memory without pointers is atomic (not scanned by GC)
+    MemoryAllocSet getMemoryAllocSet(mlir::Type llvmStorageType, MemoryAllocSet zero = MemoryAllocSet::None)
+    {
+        TypeHelper th(rewriter);
+        if (th.isPointerFree(llvmStorageType))
+        {
+            return zero == MemoryAllocSet::Zero ? MemoryAllocSet::AtomicZero : MemoryAllocSet::Atomic;
+        }
+
+        return zero;
+    }
+
     mlir::Value MemoryAllocBitcast(mlir::Type res, mlir::Type storageType, MemoryAllocSet zero = MemoryAllocSet::None)
     {
         auto loc = op->getLoc();
@@ -276,14 +331,15 @@ class LLVMCodeHelperBase
         }
 
         auto callResults = rewriter.create<LLVM::CallOp>(loc, mallocFuncOp, ValueRange{effectiveSize});
-        if (memAllocMode == MemoryAllocSet::Atomic)
+        if (memAllocMode == MemoryAllocSet::Atomic || memAllocMode == MemoryAllocSet::AtomicZero)
         {
             callResults->setAttr("mode", rewriter.getStringAttr("atomic"));
         }
 
         auto ptr = callResults.getResult();
 
-        if (memAllocMode == MemoryAllocSet::Zero)
+        // atomic memory from GC is not cleared
+        if (memAllocMode == MemoryAllocSet::Zero || memAllocMode == MemoryAllocSet::AtomicZero)
         {
             // TODO: replace with @llvm.memset.p0.i64 & @llvm.memset.p0.i32
             auto memsetFuncOp = getOrInsertFunction("memset", th.getFunctionType(i8PtrTy, {i8PtrTy, th.getI32Type(), llvmIndexType}));
@@ -0,0 +1,183 @@
+#ifndef MLIR_TYPESCRIPT_LOWERTOLLVMLOGIC_STRINGBUILDERLOGIC_H_
+#define MLIR_TYPESCRIPT_LOWERTOLLVMLOGIC_STRINGBUILDERLOGIC_H_
+
+#include "TypeScript/Config.h"
+#include "TypeScript/Defines.h"
+#include "TypeScript/Passes.h"
+#include "TypeScript/TypeScriptDialect.h"
+#include "TypeScript/TypeScriptOps.h"
+
+#include "TypeScript/LowerToLLVM/TypeHelper.h"
+#include "TypeScript/LowerToLLVM/TypeConverterHelper.h"
+#include "TypeScript/LowerToLLVM/CodeLogicHelper.h"
+#include "TypeScript/LowerToLLVM/LLVMCodeHelperBase.h"
+
+using namespace mlir;
+namespace mlir_ts = mlir::typescript;
+
+namespace typescript
+{
+
+// String in growable buffer: header { capacity, length } is placed in front of characters, value of string points to
+// characters, so it is normal null-terminated string for all other operations
+class StringBuilderLogic
+{
+    Operation *op;
+    PatternRewriter &rewriter;
+    TypeConverterHelper &tch;
+    TypeHelper th;
+    LLVMCodeHelperBase ch;
+    CodeLogicHelper clh;
+    Location loc;
+
+  protected:
+    mlir::Type llvmIndexType;
+    mlir::Type i8PtrTy;
+
+  public:
+    StringBuilderLogic(Operation *op, PatternRewriter &rewriter, TypeConverterHelper &tch, Location loc,
+                       CompileOptions &compileOptions)
+        : op(op), rewriter(rewriter), tch(tch), th(rewriter), ch(op, rewriter, &tch.typeConverter, compileOptions),
+          clh(op, rewriter), loc(loc)
+    {
+        llvmIndexType = tch.convertType(th.getIndexType());
+        i8PtrTy = th.getI8PtrType();
+    }
+
+    LLVM::LLVMStructType getHeaderType()
+    {
+        return LLVM::LLVMStructType::getLiteral(rewriter.getContext(), {llvmIndexType, llvmIndexType}, false);
+    }
+
+    // copies string of given length into new buffer
+    mlir::Value create(mlir::Value str, mlir::Value length)
+    {
+        auto one = clh.createIndexConstantOf(llvmIndexType, 1);
+        auto minCapacity = clh.createIndexConstantOf(llvmIndexType, STRING_BUILDER_MIN_CAPACITY);
+
+        auto required = rewriter.create<LLVM::AddOp>(loc, llvmIndexType, ValueRange{length, one});
+        auto capacity = max(required, minCapacity);
+
+        auto chars = newBuffer(capacity, length);
+        copyMem(chars, str, length);
+        setEnd(chars, length);
+        return chars;
+    }
+
+    // appends parts (with their sizes) to string in buffer, buffer is reallocated when capacity is not enough
+    mlir::Value append(mlir::Value value, mlir::ValueRange parts, mlir::ValueRange sizes)
+    {
+        // string is not set yet
+        auto nullValue = rewriter.create<LLVM::NullOp>(loc, i8PtrTy);
+        auto isNull = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, value, nullValue);
+        auto chars = clh.conditionalExpressionLowering(
+            loc, i8PtrTy, isNull,
+            [&](OpBuilder &builder, Location loc) {
+                auto minCapacity = clh.createIndexConstantOf(llvmIndexType, STRING_BUILDER_MIN_CAPACITY);
+                auto zero = clh.createIndexConstantOf(llvmIndexType, 0);
+                auto emptyChars = newBuffer(minCapacity, zero);
+                setEnd(emptyChars, zero);
+                return emptyChars;
+            },
+            [&](OpBuilder &builder, Location loc) { return value; });
+
+        auto headerPtr = getHeaderPtr(chars);
+        auto capacity = rewriter.create<LLVM::LoadOp>(loc, getFieldPtr(headerPtr, 0));
+        auto length = rewriter.create<LLVM::LoadOp>(loc, getFieldPtr(headerPtr, 1));
+
+        mlir::Value newLength = length;
+        for (auto size : sizes)
+        {
+            newLength = rewriter.create<LLVM::AddOp>(loc, llvmIndexType, ValueRange{newLength, size});
+        }
+
+        auto one = clh.createIndexConstantOf(llvmIndexType, 1);
+        auto required = rewriter.create<LLVM::AddOp>(loc, llvmIndexType, ValueRange{newLength, one});
+        auto notEnough = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::ugt, required, capacity);
+
+        auto buffer = clh.conditionalExpressionLowering(
+            loc, i8PtrTy, notEnough,
+            [&](OpBuilder &builder, Location loc) {
+                // grow geometrically, so n appends cost O(n) copies in total
+                auto two = clh.createIndexConstantOf(llvmIndexType, 2);
+                auto doubled = rewriter.create<LLVM::MulOp>(loc, llvmIndexType, ValueRange{capacity, two});
+                auto newChars = newBuffer(max(doubled, required), length);
+                copyMem(newChars, chars, length);
+                return newChars;
+            },
+            [&](OpBuilder &builder, Location loc) { return chars; });
+
+        mlir::Value dest = rewriter.create<LLVM::GEPOp>(loc, i8PtrTy, buffer, ValueRange{length});
+        for (auto [part, size] : llvm::zip(parts, sizes))
+        {
+            copyMem(dest, part, size);
+            dest = rewriter.create<LLVM::GEPOp>(loc, i8PtrTy, dest, ValueRange{size});
+        }
+
+        rewriter.create<LLVM::StoreOp>(loc, clh.createI8ConstantOf(0), dest);
+        rewriter.create<LLVM::StoreOp>(loc, newLength, getFieldPtr(getHeaderPtr(buffer), 1));
+
+        return buffer;
+    }
+
+  private:
+    mlir::Value newBuffer(mlir::Value capacity, mlir::Value length)
+    {
+        auto headerType = getHeaderType();
+        auto headerPtrType = LLVM::LLVMPointerType::get(headerType);
+
+        auto sizeOfHeaderMLIR = rewriter.create<mlir_ts::SizeOfOp>(loc, th.getIndexType(), headerType);
+        auto sizeOfHeader = rewriter.create<mlir_ts::DialectCastOp>(loc, llvmIndexType, sizeOfHeaderMLIR);
+        auto size = rewriter.create<LLVM::AddOp>(loc, llvmIndexType, ValueRange{sizeOfHeader, capacity});
+
+        // characters only, nothing to scan
+        auto headerPtr = ch.MemoryAllocBitcast(headerPtrType, size, MemoryAllocSet::Atomic);
+        rewriter.create<LLVM::StoreOp>(loc, capacity, getFieldPtr(headerPtr, 0));
+        rewriter.create<LLVM::StoreOp>(loc, length, getFieldPtr(headerPtr, 1));
+
+        auto one = clh.createI32ConstantOf(1);
+        auto charsPtr = rewriter.create<LLVM::GEPOp>(loc, headerPtrType, headerPtr, ValueRange{one});
+        return rewriter.create<LLVM::BitcastOp>(loc, i8PtrTy, charsPtr);
+    }
+
+    mlir::Value getHeaderPtr(mlir::Value chars)
+    {
+        auto headerPtrType = LLVM::LLVMPointerType::get(getHeaderType());
+        auto charsAsHeaderPtr = rewriter.create<LLVM::BitcastOp>(loc, headerPtrType, chars);
+        auto minusOne = clh.createI32ConstantOf(-1);
+        return rewriter.create<LLVM::GEPOp>(loc, headerPtrType, charsAsHeaderPtr, ValueRange{minusOne});
+    }
+
+    mlir::Value getFieldPtr(mlir::Value headerPtr, int index)
+    {
+        auto zero = clh.createI32ConstantOf(0);
+        auto fieldIndex = clh.createI32ConstantOf(index);
+        return rewriter.create<LLVM::GEPOp>(loc, LLVM::LLVMPointerType::get(llvmIndexType), headerPtr,
+                                            ValueRange{zero, fieldIndex});
+    }
+
+    mlir::Value max(mlir::Value value1, mlir::Value value2)
+    {
+        auto cmpVal = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::ugt, value1, value2);
+        return rewriter.create<LLVM::SelectOp>(loc, cmpVal, value1, value2);
+    }
+
+    void setEnd(mlir::Value chars, mlir::Value length)
+    {
+        auto end = rewriter.create<LLVM::GEPOp>(loc, i8PtrTy, chars, ValueRange{length});
+        rewriter.create<LLVM::StoreOp>(loc, clh.createI8ConstantOf(0), end);
+    }
+
+    void copyMem(mlir::Value dest, mlir::Value src, mlir::Value size)
+    {
+        auto copyMemFuncOp = ch.getOrInsertFunction(
+            llvmIndexType.getIntOrFloatBitWidth() == 32 ? "llvm.memcpy.p0.p0.i32" : "llvm.memcpy.p0.p0.i64",
+            th.getFunctionType(th.getVoidType(), {i8PtrTy, i8PtrTy, llvmIndexType, th.getLLVMBoolType()}));
+
+        auto immarg = clh.createI1ConstantOf(false);
+        rewriter.create<LLVM::CallOp>(loc, copyMemFuncOp, ValueRange{dest, src, size, immarg});
+    }
+};
+} // namespace typescript
+
+#endif // MLIR_TYPESCRIPT_LOWERTOLLVMLOGIC_STRINGBUILDERLOGIC_H_
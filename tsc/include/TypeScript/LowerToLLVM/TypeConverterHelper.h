@@ -37,6 +37,13 @@ class TypeConverterHelper
         return type;
     }
 
+    // optional of reference type is the reference itself (null is "no value"), others are { value, hasValue }
+    static bool isNullNicheOptional(mlir_ts::OptionalType optType)
+    {
+        auto elementType = optType.getElementType();
+        return elementType.isa<mlir_ts::ClassType>() || elementType.isa<mlir_ts::StringType>();
+    }
+
     mlir::Type makePtrToValue(mlir::Type type)
     {
         if (auto constArray = type.dyn_cast<mlir_ts::ConstArrayType>())
@@ -145,6 +145,37 @@ class TypeHelper
     {
         return LLVM::LLVMFunctionType::get(getVoidType(), arguments, isVarArg);
     }
+
+    // memory of type without pointers does not need to be scanned by GC
+    bool isPointerFree(mlir::Type llvmType)
+    {
+        if (llvmType.isa<mlir::IntegerType>() || llvmType.isa<mlir::FloatType>())
+        {
+            return true;
+        }
+
+        if (auto arrayType = llvmType.dyn_cast<LLVM::LLVMArrayType>())
+        {
+            return isPointerFree(arrayType.getElementType());
+        }
+
+        if (auto vectorType = llvmType.dyn_cast<mlir::VectorType>())
+        {
+            return isPointerFree(vectorType.getElementType());
+        }
+
+        if (auto structType = llvmType.dyn_cast<LLVM::LLVMStructType>())
+        {
+            if (structType.isOpaque())
+            {
+                return false;
+            }
+
+            return llvm::all_of(structType.getBody(), [&](mlir::Type fieldType) { return isPointerFree(fieldType); });
+        }
+
+        return false;
+    }
 };
 
 } // namespace typescript
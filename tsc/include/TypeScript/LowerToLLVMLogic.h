@@ -21,5 +21,6 @@
 #include "TypeScript/LowerToLLVM/UndefLogicHelper.h"
 #include "TypeScript/LowerToLLVM/TypeOfOpHelper.h"
 #include "TypeScript/LowerToLLVM/ThrowLogic.h"
+#include "TypeScript/LowerToLLVM/StringBuilderLogic.h"
 
 #endif // MLIR_TYPESCRIPT_LOWERTOLLVMLOGIC_H_
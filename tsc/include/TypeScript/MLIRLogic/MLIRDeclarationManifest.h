@@ -0,0 +1,263 @@
+#ifndef MLIR_TYPESCRIPT_COMMONGENLOGIC_MLIRDECLARATIONMANIFEST_H_
+#define MLIR_TYPESCRIPT_COMMONGENLOGIC_MLIRDECLARATIONMANIFEST_H_
+
+#include "mlir/AsmParser/AsmParser.h"
+#include "mlir/IR/Attributes.h"
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/IR/Types.h"
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <cstdint>
+#include <string>
+
+// binary manifest layout (all integers are little endian), size of data is exported as separate u32 symbol:
+//   magic "TSDM", u8 version, u32 count,
+//   count * { u8 kind, u32 nameSize, name, u32 payloadSize, payload, [u32 extraSize, extra] }
+// 'payload' for Function/TypeAlias/Enum is MLIR asm form of the type, 'extra' for Enum is MLIR asm form of values
+// dictionary, for Source it is TypeScript declaration text which does not have binary form yet (classes, interfaces,
+// variables)
+#define DECLARATION_MANIFEST_MAGIC "TSDM"
+#define DECLARATION_MANIFEST_VERSION 1
+
+namespace typescript
+{
+
+enum class DeclarationManifestKind : uint8_t
+{
+    Function = 1,
+    TypeAlias = 2,
+    Enum = 3,
+    Source = 4
+};
+
+struct DeclarationManifestRecord
+{
+    DeclarationManifestKind kind;
+    std::string name;
+    std::string payload;
+    std::string extra;
+};
+
+class DeclarationManifestWriter
+{
+    llvm::SmallVector<DeclarationManifestRecord> records;
+    llvm::StringMap<size_t> recordIndexByName;
+
+    static std::string toString(mlir::Type type)
+    {
+        std::string str;
+        llvm::raw_string_ostream os(str);
+        type.print(os);
+        return os.str();
+    }
+
+    static std::string toString(mlir::Attribute attr)
+    {
+        std::string str;
+        llvm::raw_string_ostream os(str);
+        attr.print(os);
+        return os.str();
+    }
+
+    static void writeU32(std::string &out, uint32_t value)
+    {
+        for (auto i = 0; i < 4; i++)
+        {
+            out.push_back(static_cast<char>((value >> (i * 8)) & 0xff));
+        }
+    }
+
+    static void writeString(std::string &out, const std::string &value)
+    {
+        writeU32(out, value.size());
+        out.append(value);
+    }
+
+    void add(DeclarationManifestKind kind, llvm::StringRef name, std::string payload, std::string extra = "")
+    {
+        // functions can be processed more than once (discovery), keep the last version only
+        auto key = (llvm::Twine(static_cast<int>(kind)) + ":" + name).str();
+        auto it = recordIndexByName.find(key);
+        if (it != recordIndexByName.end())
+        {
+            records[it->second].payload = payload;
+            records[it->second].extra = extra;
+            return;
+        }
+
+        recordIndexByName[key] = records.size();
+        records.push_back({kind, name.str(), payload, extra});
+    }
+
+  public:
+    void addFunction(llvm::StringRef name, mlir::Type funcType)
+    {
+        add(DeclarationManifestKind::Function, name, toString(funcType));
+    }
+
+    void addTypeAlias(llvm::StringRef name, mlir::Type type)
+    {
+        add(DeclarationManifestKind::TypeAlias, name, toString(type));
+    }
+
+    void addEnum(llvm::StringRef name, mlir::Type storeType, mlir::DictionaryAttr values)
+    {
+        add(DeclarationManifestKind::Enum, name, toString(storeType), toString(values));
+    }
+
+    void addSource(std::string declText)
+    {
+        records.push_back({DeclarationManifestKind::Source, "", declText, ""});
+    }
+
+    bool empty()
+    {
+        return records.empty();
+    }
+
+    void clear()
+    {
+        records.clear();
+        recordIndexByName.clear();
+    }
+
+    std::string serialize()
+    {
+        std::string out;
+        out.append(DECLARATION_MANIFEST_MAGIC);
+        out.push_back(static_cast<char>(DECLARATION_MANIFEST_VERSION));
+        writeU32(out, records.size());
+        for (auto &record : records)
+        {
+            out.push_back(static_cast<char>(record.kind));
+            writeString(out, record.name);
+            writeString(out, record.payload);
+            if (record.kind == DeclarationManifestKind::Enum)
+            {
+                writeString(out, record.extra);
+            }
+        }
+
+        return out;
+    }
+};
+
+class DeclarationManifestReader
+{
+    const char *data;
+    size_t size;
+    size_t pos;
+    // set when data ends before the value which is read
+    bool overrun;
+
+    bool canRead(size_t count)
+    {
+        if (overrun || size - pos < count)
+        {
+            overrun = true;
+            return false;
+        }
+
+        return true;
+    }
+
+    uint8_t readU8()
+    {
+        return canRead(1) ? static_cast<uint8_t>(data[pos++]) : 0;
+    }
+
+    uint32_t readU32()
+    {
+        if (!canRead(4))
+        {
+            return 0;
+        }
+
+        uint32_t value = 0;
+        for (auto i = 0; i < 4; i++)
+        {
+            value |= static_cast<uint32_t>(static_cast<uint8_t>(data[pos++])) << (i * 8);
+        }
+
+        return value;
+    }
+
+    std::string readString()
+    {
+        auto length = readU32();
+        if (!canRead(length))
+        {
+            return std::string();
+        }
+
+        std::string value(data + pos, length);
+        pos += length;
+        return value;
+    }
+
+  public:
+    // size is size of manifest data emitted next to it by library
+    DeclarationManifestReader(const char *data, size_t size) : data(data), size(data ? size : 0), pos(0), overrun(false)
+    {
+    }
+
+    // returns false if data is not a manifest, was produced by unsupported version or is truncated
+    bool read(llvm::SmallVector<DeclarationManifestRecord> &records)
+    {
+        auto magicSize = sizeof(DECLARATION_MANIFEST_MAGIC) - 1;
+        if (!canRead(magicSize) || llvm::StringRef(data, magicSize) != DECLARATION_MANIFEST_MAGIC)
+        {
+            return false;
+        }
+
+        pos = magicSize;
+        if (readU8() != DECLARATION_MANIFEST_VERSION)
+        {
+            return false;
+        }
+
+        auto count = readU32();
+        for (uint32_t i = 0; i < count && !overrun; i++)
+        {
+            DeclarationManifestRecord record;
+            record.kind = static_cast<DeclarationManifestKind>(readU8());
+            if (record.kind < DeclarationManifestKind::Function || record.kind > DeclarationManifestKind::Source)
+            {
+                return false;
+            }
+
+            record.name = readString();
+            record.payload = readString();
+            if (record.kind == DeclarationManifestKind::Enum)
+            {
+                record.extra = readString();
+            }
+
+            records.push_back(record);
+        }
+
+        return !overrun && pos == size;
+    }
+
+    static mlir::Type parseType(mlir::MLIRContext *context, const std::string &text)
+    {
+        size_t numRead = 0;
+        auto type = mlir::parseType(text, context, &numRead);
+        return type && numRead == text.size() ? type : mlir::Type();
+    }
+
+    static mlir::DictionaryAttr parseDictionary(mlir::MLIRContext *context, const std::string &text)
+    {
+        size_t numRead = 0;
+        auto attr = mlir::parseAttribute(text, context, mlir::Type(), &numRead);
+        return attr && numRead == text.size() ? attr.dyn_cast<mlir::DictionaryAttr>() : mlir::DictionaryAttr();
+    }
+};
+
+} // namespace typescript
+
+#endif // MLIR_TYPESCRIPT_COMMONGENLOGIC_MLIRDECLARATIONMANIFEST_H_
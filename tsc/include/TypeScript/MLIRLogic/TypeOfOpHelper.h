@@ -33,177 +33,160 @@ class TypeOfOpHelper
         return typeOfValue;
     }
 
-    mlir::Value typeOfLogic(mlir::Location loc, mlir::Type type)
+    // returns empty string if type name can't be resolved at compile time
+    static std::string typeOfName(mlir::Type type)
     {
         if (type.isIntOrIndex() && !type.isIndex())
         {
             std::stringstream val;
             val << "i" << type.getIntOrFloatBitWidth();
-            auto typeOfValue = strValue(loc, val.str());
-            return typeOfValue;
+            return val.str();
         }
 
         if (type.isIntOrFloat() && !type.isIntOrIndex())
         {
             std::stringstream val;
             val << "f" << type.getIntOrFloatBitWidth();
-            auto typeOfValue = strValue(loc, val.str());
-            return typeOfValue;
+            return val.str();
         }
 
         if (type.isIndex())
         {
-            auto typeOfValue = strValue(loc, "ptrint");
-            return typeOfValue;
+            return "ptrint";
         }
 
         if (type.isa<mlir_ts::BooleanType>())
         {
-            auto typeOfValue = strValue(loc, "boolean");
-            return typeOfValue;
+            return "boolean";
         }
 
         // special case
         if (type.isa<mlir_ts::TypePredicateType>())
         {
-            auto typeOfValue = strValue(loc, "boolean");
-            return typeOfValue;
+            return "boolean";
         }        
 
         if (type.isa<mlir_ts::NumberType>())
         {
-            auto typeOfValue = strValue(loc, "number");
-            return typeOfValue;
+            return "number";
         }
 
         if (type.isa<mlir_ts::StringType>())
         {
-            auto typeOfValue = strValue(loc, "string");
-            return typeOfValue;
+            return "string";
         }
 
         if (type.isa<mlir_ts::ArrayType>())
         {
-            auto typeOfValue = strValue(loc, "array");
-            return typeOfValue;
+            return "array";
         }
 
         if (type.isa<mlir_ts::FunctionType>())
         {
-            auto typeOfValue = strValue(loc, "function");
-            return typeOfValue;
+            return "function";
         }
 
         if (type.isa<mlir_ts::HybridFunctionType>())
         {
-            auto typeOfValue = strValue(loc, "function");
-            return typeOfValue;
+            return "function";
         }
 
         if (type.isa<mlir_ts::BoundFunctionType>())
         {
-            auto typeOfValue = strValue(loc, "function");
-            return typeOfValue;
+            return "function";
         }
 
         if (type.isa<mlir_ts::ClassType>())
         {
-            auto typeOfValue = strValue(loc, "class");
-            return typeOfValue;
+            return "class";
         }
 
         if (type.isa<mlir_ts::ClassStorageType>())
         {
-            auto typeOfValue = strValue(loc, "class");
-            return typeOfValue;
+            return "class";
         }
 
         if (type.isa<mlir_ts::ObjectType>())
         {
-            auto typeOfValue = strValue(loc, "object");
-            return typeOfValue;
+            return "object";
         }
 
         if (type.isa<mlir_ts::InterfaceType>())
         {
-            auto typeOfValue = strValue(loc, "interface");
-            return typeOfValue;
+            return "interface";
         }
 
         if (type.isa<mlir_ts::OpaqueType>())
         {
-            auto typeOfValue = strValue(loc, "object");
-            return typeOfValue;
+            return "object";
         }
 
         if (type.isa<mlir_ts::SymbolType>())
         {
-            auto typeOfValue = strValue(loc, "symbol");
-            return typeOfValue;
+            return "symbol";
         }
 
         if (type.isa<mlir_ts::UndefinedType>())
         {
-            auto typeOfValue = strValue(loc, UNDEFINED_NAME);
-            return typeOfValue;
+            return UNDEFINED_NAME;
         }
 
         if (type.isa<mlir_ts::UnknownType>())
         {
-            auto typeOfValue = strValue(loc, "unknown");
-            return typeOfValue;
+            return "unknown";
         }
 
         if (type.isa<mlir_ts::ConstTupleType>())
         {
-            auto typeOfValue = strValue(loc, "tuple");
-            return typeOfValue;
+            return "tuple";
         }
 
         if (type.isa<mlir_ts::TupleType>())
         {
-            auto typeOfValue = strValue(loc, "tuple");
-            return typeOfValue;
-        }
-
-        if (type.isa<mlir_ts::ArrayType>())
-        {
-            auto typeOfValue = strValue(loc, "array");
-            return typeOfValue;
+            return "tuple";
         }
 
         if (type.isa<mlir_ts::ConstArrayType>())
         {
-            auto typeOfValue = strValue(loc, "array");
-            return typeOfValue;
+            return "array";
         }
 
         if (auto subType = type.dyn_cast<mlir_ts::RefType>())
         {
-            return typeOfLogic(loc, subType.getElementType());
+            return typeOfName(subType.getElementType());
         }
 
         if (auto subType = type.dyn_cast<mlir_ts::ValueRefType>())
         {
-            return typeOfLogic(loc, subType.getElementType());
+            return typeOfName(subType.getElementType());
         }
 
         if (auto subType = type.dyn_cast<mlir_ts::OptionalType>())
         {
-            return typeOfLogic(loc, subType.getElementType());
+            return typeOfName(subType.getElementType());
         }
 
         if (auto literalType = type.dyn_cast<mlir_ts::LiteralType>())
         {
-            return typeOfLogic(loc, literalType.getElementType());
+            return typeOfName(literalType.getElementType());
         }
 
         if (type.isa<mlir_ts::NullType>())
         {
-            auto typeOfValue = strValue(loc, "null");
-            return typeOfValue;
+            return "null";
         }        
 
+        return "";
+    }
+
+    mlir::Value typeOfLogic(mlir::Location loc, mlir::Type type)
+    {
+        auto name = typeOfName(type);
+        if (!name.empty())
+        {
+            return strValue(loc, name);
+        }
+
         LLVM_DEBUG(llvm::dbgs() << "TypeOf: " << type << "\n");
 
         llvm_unreachable("not implemented");
@@ -0,0 +1,40 @@
+#ifndef MLIR_TYPESCRIPT_MEMORYSTATS_H_
+#define MLIR_TYPESCRIPT_MEMORYSTATS_H_
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace mlir
+{
+class Operation;
+} // namespace mlir
+
+namespace typescript
+{
+
+// collects allocated bytes per compiler phase and amount of operations at each lowering stage (--print-memory-stats)
+class MemoryStats
+{
+  public:
+    static void enable();
+    static bool isEnabled();
+
+    static void recordOpCount(llvm::StringRef stage, mlir::Operation *op);
+
+    static void print(llvm::raw_ostream &os);
+};
+
+// attributes memory (malloc in use) allocated between creation and destruction to phase, nested scopes are excluded
+// from parent phase
+class MemoryStatsScope
+{
+    bool active;
+
+  public:
+    MemoryStatsScope(llvm::StringRef phase);
+    ~MemoryStatsScope();
+};
+
+} // namespace typescript
+
+#endif // MLIR_TYPESCRIPT_MEMORYSTATS_H_
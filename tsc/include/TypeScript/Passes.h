@@ -26,6 +26,24 @@ std::unique_ptr<mlir::Pass> createLowerToLLVMPass(CompileOptions&);
 // TODO: should you process, switch satate in createLowerToAffinePass to resolve issue?
 std::unique_ptr<mlir::Pass> createRelocateConstantPass();
 
+/// Class hierarchy analysis pass to replace virtual method calls with direct (or guarded direct) calls, requires whole program
+std::unique_ptr<mlir::Pass> createDevirtualizePass();
+
+/// Escape analysis pass to allocate in stack class instances which never leave their function
+std::unique_ptr<mlir::Pass> createEscapeAnalysisPass();
+
+/// Escape analysis pass to keep in stack capture records and captured variables of closures which never leave their function
+std::unique_ptr<mlir::Pass> createClosureEscapePass();
+
+/// String builder pass to accumulate strings concatenated in loops in growable buffer instead of new string per iteration
+std::unique_ptr<mlir::Pass> createStringBuilderPass();
+
+/// Integer range analysis pass to compute 'number' variables and values which are proven integers in i32/i64
+std::unique_ptr<mlir::Pass> createIntegerRangePass();
+
+/// Function attributes inference pass (nounwind, willreturn, memory) on LLVM dialect, replaces invoke of functions which can't unwind with call
+std::unique_ptr<mlir::Pass> createFunctionAttrsPass();
+
 /// GC Pass to replace malloc, realloc, free with GC_malloc, GC_realloc, GC_free
 std::unique_ptr<mlir::Pass> createGCPass(CompileOptions&);
 /// MemAlloc Pass to replace ts_malloc, ts_realloc, ts_free
@@ -0,0 +1,449 @@
+#define DEBUG_TYPE "pass"
+
+#include "mlir/Pass/Pass.h"
+
+#include "TypeScript/TypeScriptDialect.h"
+#include "TypeScript/TypeScriptOps.h"
+#include "TypeScript/Passes.h"
+#include "TypeScript/ModulePass.h"
+
+#include "mlir/Dialect/Async/IR/Async.h"
+#include "mlir/IR/Dominance.h"
+#include "mlir/IR/SymbolTable.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace mlir_ts = mlir::typescript;
+
+namespace
+{
+
+enum class ParamState
+{
+    Unknown,
+    InProgress,
+    NotEscaping,
+    Escaping
+};
+
+// Closures which never leave the function they are created in (callbacks of forEach/every/some, immediately invoked
+// lambdas etc.) do not need captured variables and capture record in heap: the closure can't be called after the
+// frame is gone. Capture record (ts.Capture) is marked to be allocated in stack and captured variables which are
+// captured only by such closures lose 'captured' flag.
+// Frame references (capture record, bound function, references to captured variables) may be used only for
+//  - loads and stores through them (but not stored themselves into other objects)
+//  - creating bound function, getting 'this' and method of bound function
+//  - stores into local (not captured) variables, loads from such variables are followed as the same value
+//  - passing into functions which do not let the parameter escape (the closure body itself is checked the same way)
+// Any other use (return, store into heap, capture by other closure, async, unknown callee etc.) is escape, closure
+// stays in heap.
+class ClosureEscapePass : public mlir::PassWrapper<ClosureEscapePass, ModulePass>
+{
+    // function -> state of parameters
+    llvm::DenseMap<mlir::Operation *, llvm::SmallVector<ParamState>> paramStates;
+    int inProgressCount = 0;
+
+  public:
+    MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(ClosureEscapePass)
+
+    void runOnModule() override
+    {
+        auto m = getModule();
+
+        mlir::SymbolTable symbolTable(m);
+
+        paramStates.clear();
+
+        llvm::SmallPtrSet<mlir::Operation *, 16> stackCaptures;
+        m.walk([&](mlir_ts::FuncOp funcOp) {
+            if (funcOp.isExternal())
+            {
+                return;
+            }
+
+            llvm::SmallVector<mlir_ts::CaptureOp> captureOps;
+            funcOp.walk([&](mlir_ts::CaptureOp captureOp) { captureOps.push_back(captureOp); });
+            if (captureOps.empty())
+            {
+                return;
+            }
+
+            mlir::DominanceInfo dom(funcOp);
+            for (auto captureOp : captureOps)
+            {
+                if (escapes(captureOp.getResult(), funcOp, dom, symbolTable))
+                {
+                    continue;
+                }
+
+                LLVM_DEBUG(llvm::dbgs() << "\n!! capture in stack: " << captureOp << "\n";);
+
+                captureOp.setStackAllocAttr(mlir::BoolAttr::get(m.getContext(), true));
+                stackCaptures.insert(captureOp);
+            }
+        });
+
+        for (auto *captureOp : stackCaptures)
+        {
+            for (auto captured : captureOp->getOperands())
+            {
+                releaseCapturedVariable(captured, stackCaptures);
+            }
+        }
+
+        LLVM_DEBUG(llvm::dbgs() << "\n!! AFTER CLOSURE ESCAPE ANALYSIS DUMP: \n" << m << "\n";);
+    }
+
+  private:
+    // variable is allocated in stack if all closures which capture it are not escaping
+    void releaseCapturedVariable(mlir::Value captured, llvm::SmallPtrSetImpl<mlir::Operation *> &stackCaptures)
+    {
+        auto *defOp = captured.getDefiningOp();
+        if (!defOp || !isa<mlir_ts::VariableOp, mlir_ts::ParamOp, mlir_ts::ParamOptionalOp>(defOp))
+        {
+            return;
+        }
+
+        for (auto *user : captured.getUsers())
+        {
+            if (isa<mlir_ts::LoadOp>(user))
+            {
+                continue;
+            }
+
+            if (auto storeOp = dyn_cast<mlir_ts::StoreOp>(user))
+            {
+                if (storeOp.getReference() == captured && storeOp.getValue() != captured)
+                {
+                    continue;
+                }
+            }
+
+            if (isa<mlir_ts::CaptureOp>(user) && stackCaptures.count(user))
+            {
+                continue;
+            }
+
+            return;
+        }
+
+        auto notCaptured = mlir::BoolAttr::get(defOp->getContext(), false);
+        if (auto varOp = dyn_cast<mlir_ts::VariableOp>(defOp))
+        {
+            varOp.setCapturedAttr(notCaptured);
+        }
+        else if (auto paramOp = dyn_cast<mlir_ts::ParamOp>(defOp))
+        {
+            paramOp.setCapturedAttr(notCaptured);
+        }
+        else if (auto paramOptOp = dyn_cast<mlir_ts::ParamOptionalOp>(defOp))
+        {
+            paramOptOp.setCapturedAttr(notCaptured);
+        }
+    }
+
+    // only such values can hold reference into frame of function
+    bool isFrameRefLike(mlir::Type type)
+    {
+        if (type.isa<mlir_ts::RefType, mlir_ts::ValueRefType, mlir_ts::BoundRefType, mlir_ts::OpaqueType,
+                     mlir_ts::BoundFunctionType, mlir_ts::HybridFunctionType, mlir_ts::AnyType,
+                     mlir_ts::UnionType>())
+        {
+            return true;
+        }
+
+        if (auto optType = type.dyn_cast<mlir_ts::OptionalType>())
+        {
+            return isFrameRefLike(optType.getElementType());
+        }
+
+        if (auto tupleType = type.dyn_cast<mlir_ts::TupleType>())
+        {
+            return llvm::any_of(tupleType.getFields(), [&](auto field) { return isFrameRefLike(field.type); });
+        }
+
+        if (auto constTupleType = type.dyn_cast<mlir_ts::ConstTupleType>())
+        {
+            return llvm::any_of(constTupleType.getFields(), [&](auto field) { return isFrameRefLike(field.type); });
+        }
+
+        return false;
+    }
+
+    // async body can be executed after function is finished
+    bool isInFrame(mlir::Operation *op, mlir_ts::FuncOp funcOp)
+    {
+        auto *parentOp = op->getParentOp();
+        for (; parentOp && parentOp != funcOp; parentOp = parentOp->getParentOp())
+        {
+            if (isa<mlir::async::ExecuteOp>(parentOp))
+            {
+                return false;
+            }
+        }
+
+        return parentOp == funcOp;
+    }
+
+    bool isParamEscaping(mlir::StringRef calleeName, unsigned index, mlir::SymbolTable &symbolTable)
+    {
+        auto calleeOp = symbolTable.lookup<mlir_ts::FuncOp>(calleeName);
+        if (!calleeOp || calleeOp.isExternal() || index >= calleeOp.getNumArguments())
+        {
+            return true;
+        }
+
+        auto &states = paramStates[calleeOp];
+        if (states.empty())
+        {
+            states.assign(calleeOp.getNumArguments(), ParamState::Unknown);
+        }
+
+        switch (states[index])
+        {
+        case ParamState::InProgress:
+            // recursive call, the answer is given by the first visit
+        case ParamState::NotEscaping:
+            return false;
+        case ParamState::Escaping:
+            return true;
+        default:
+            break;
+        }
+
+        states[index] = ParamState::InProgress;
+        inProgressCount++;
+
+        mlir::DominanceInfo dom(calleeOp);
+        auto result = escapes(calleeOp.getBody().front().getArgument(index), calleeOp, dom, symbolTable);
+
+        inProgressCount--;
+
+        // 'not escaping' may depend on assumption about parameters in progress, so it is final only for outermost call
+        auto &finalStates = paramStates[calleeOp];
+        finalStates[index] = result
+            ? ParamState::Escaping
+            : inProgressCount == 0 ? ParamState::NotEscaping : ParamState::Unknown;
+        return result;
+    }
+
+    bool escapes(mlir::Value value, mlir_ts::FuncOp funcOp, mlir::DominanceInfo &dom, mlir::SymbolTable &symbolTable)
+    {
+        llvm::SmallVector<mlir::Value> worklist{value};
+        llvm::DenseSet<mlir::Value> aliases;
+
+        // local variables which hold the value and stores of the value into them
+        llvm::DenseMap<mlir::Operation *, llvm::SmallVector<mlir::Operation *>> variableStores;
+
+        auto trackVariable = [&](mlir_ts::VariableOp variableOp, mlir::Operation *storeOp) {
+            if (!isInFrame(variableOp, funcOp) ||
+                (variableOp.getCaptured().has_value() && variableOp.getCaptured().value()))
+            {
+                return false;
+            }
+
+            auto inserted = !variableStores.count(variableOp);
+            variableStores[variableOp].push_back(storeOp);
+            if (!inserted)
+            {
+                return true;
+            }
+
+            for (auto *user : variableOp->getUsers())
+            {
+                if (auto loadOp = dyn_cast<mlir_ts::LoadOp>(user))
+                {
+                    worklist.push_back(loadOp.getResult());
+                    continue;
+                }
+
+                if (auto userStoreOp = dyn_cast<mlir_ts::StoreOp>(user))
+                {
+                    if (userStoreOp.getReference() == variableOp.getReference() &&
+                        userStoreOp.getValue() != variableOp.getReference())
+                    {
+                        continue;
+                    }
+                }
+
+                return false;
+            }
+
+            return true;
+        };
+
+        auto follow = [&](mlir::Value result) {
+            if (isFrameRefLike(result.getType()))
+            {
+                worklist.push_back(result);
+            }
+        };
+
+        while (!worklist.empty())
+        {
+            auto current = worklist.pop_back_val();
+            if (!aliases.insert(current).second)
+            {
+                continue;
+            }
+
+            for (auto &use : current.getUses())
+            {
+                auto *user = use.getOwner();
+
+                if (!isInFrame(user, funcOp))
+                {
+                    return true;
+                }
+
+                if (auto castOp = dyn_cast<mlir_ts::CastOp>(user))
+                {
+                    follow(castOp.getRes());
+                    continue;
+                }
+
+                if (auto createBoundFunctionOp = dyn_cast<mlir_ts::CreateBoundFunctionOp>(user))
+                {
+                    if (createBoundFunctionOp.getThisVal() == current)
+                    {
+                        worklist.push_back(createBoundFunctionOp.getResult());
+                        continue;
+                    }
+
+                    return true;
+                }
+
+                if (auto getThisOp = dyn_cast<mlir_ts::GetThisOp>(user))
+                {
+                    worklist.push_back(getThisOp.getResult());
+                    continue;
+                }
+
+                if (isa<mlir_ts::GetMethodOp>(user))
+                {
+                    // method itself does not hold 'this'
+                    continue;
+                }
+
+                if (auto propertyRefOp = dyn_cast<mlir_ts::PropertyRefOp>(user))
+                {
+                    worklist.push_back(propertyRefOp.getResult());
+                    continue;
+                }
+
+                if (auto extractPropertyOp = dyn_cast<mlir_ts::ExtractPropertyOp>(user))
+                {
+                    follow(extractPropertyOp.getResult());
+                    continue;
+                }
+
+                if (auto loadOp = dyn_cast<mlir_ts::LoadOp>(user))
+                {
+                    follow(loadOp.getResult());
+                    continue;
+                }
+
+                if (auto storeOp = dyn_cast<mlir_ts::StoreOp>(user))
+                {
+                    if (storeOp.getReference() == current && storeOp.getValue() != current)
+                    {
+                        continue;
+                    }
+
+                    auto variableOp = storeOp.getReference().getDefiningOp<mlir_ts::VariableOp>();
+                    if (variableOp && trackVariable(variableOp, storeOp))
+                    {
+                        continue;
+                    }
+
+                    return true;
+                }
+
+                if (auto variableOp = dyn_cast<mlir_ts::VariableOp>(user))
+                {
+                    if (trackVariable(variableOp, variableOp))
+                    {
+                        continue;
+                    }
+
+                    return true;
+                }
+
+                if (auto callOp = dyn_cast<mlir_ts::CallOp>(user))
+                {
+                    if (!isParamEscaping(callOp.getCallee(), use.getOperandNumber(), symbolTable))
+                    {
+                        continue;
+                    }
+
+                    return true;
+                }
+
+                if (auto callIndirectOp = dyn_cast<mlir_ts::CallIndirectOp>(user))
+                {
+                    // call of closure which is not simplified by canonicalization: bound_func.method(bound_func.this)
+                    if (use.getOperandNumber() > 0)
+                    {
+                        if (auto getMethodOp = callIndirectOp.getCallee().getDefiningOp<mlir_ts::GetMethodOp>())
+                        {
+                            if (auto createBoundFunctionOp =
+                                    getMethodOp.getBoundFunc().getDefiningOp<mlir_ts::CreateBoundFunctionOp>())
+                            {
+                                if (auto symbolRefOp =
+                                        createBoundFunctionOp.getFunc().getDefiningOp<mlir_ts::SymbolRefOp>())
+                                {
+                                    if (!isParamEscaping(symbolRefOp.getIdentifier(), use.getOperandNumber() - 1,
+                                                         symbolTable))
+                                    {
+                                        continue;
+                                    }
+                                }
+                            }
+                        }
+                    }
+
+                    return true;
+                }
+
+                return true;
+            }
+        }
+
+        // stack capture is reused when it is created again (in loop), so each load from variable must see the value
+        // stored after the last creation
+        for (auto &variableStore : variableStores)
+        {
+            for (auto *user : variableStore.first->getUsers())
+            {
+                auto loadOp = dyn_cast<mlir_ts::LoadOp>(user);
+                if (!loadOp)
+                {
+                    continue;
+                }
+
+                auto dominated = llvm::any_of(variableStore.second, [&](mlir::Operation *storeOp) {
+                    return dom.properlyDominates(storeOp, loadOp);
+                });
+
+                if (!dominated)
+                {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+};
+
+} // end anonymous namespace
+
+std::unique_ptr<mlir::Pass> mlir_ts::createClosureEscapePass()
+{
+    return std::make_unique<ClosureEscapePass>();
+}
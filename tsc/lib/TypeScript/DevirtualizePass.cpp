@@ -0,0 +1,438 @@
+#define DEBUG_TYPE "pass"
+
+#include "mlir/Pass/Pass.h"
+
+#include "TypeScript/Defines.h"
+#include "TypeScript/TypeScriptDialect.h"
+#include "TypeScript/TypeScriptOps.h"
+#include "TypeScript/Passes.h"
+#include "TypeScript/ModulePass.h"
+
+#include "mlir/IR/SymbolTable.h"
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "scanner_enums.h"
+
+// max count of classes which can be checked before falling back to virtual call
+#define MAX_SPECULATIVE_TARGETS 3
+
+namespace mlir_ts = mlir::typescript;
+
+namespace
+{
+
+struct ClassVTableInfo
+{
+    // base class name, empty for root class
+    mlir::StringRef baseName;
+    mlir_ts::GlobalOp vtableGlobal;
+    // vtable slot -> method symbol, empty symbol if slot is not a method (interface vtable, static field)
+    llvm::SmallVector<mlir::FlatSymbolRefAttr> slots;
+    bool instantiated;
+    // class is declared in or shared with other module (shared library), its subclasses are not all visible
+    bool external;
+};
+
+struct DevirtualizeTarget
+{
+    mlir::StringRef className;
+    mlir_ts::FuncOp funcOp;
+};
+
+// Class hierarchy analysis: builds the class tree from class storage types (base class is stored as first field
+// named by base class) and the vtable globals, then replaces virtual calls with direct ones when receiver's static
+// class has only one implementation of the method in all instantiated classes. When the count of instantiated
+// classes is small each of them is checked by vtable address and called directly, so LLVM can inline hot methods.
+// Valid only when the whole program is visible (executable or JIT), no class can be extended outside of the module.
+// Classes imported from or exported to shared libraries (and their subclasses) are skipped.
+class DevirtualizePass : public mlir::PassWrapper<DevirtualizePass, ModulePass>
+{
+    llvm::StringMap<ClassVTableInfo> classes;
+
+  public:
+    MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(DevirtualizePass)
+
+    void runOnModule() override
+    {
+        auto m = getModule();
+
+        mlir::SymbolTable symbolTable(m);
+
+        classes.clear();
+        collectClasses(m, symbolTable);
+        if (classes.empty())
+        {
+            return;
+        }
+
+        llvm::SmallVector<mlir_ts::ThisVirtualSymbolRefOp> virtualRefs;
+        m.walk([&](mlir_ts::ThisVirtualSymbolRefOp thisVirtualSymbolRefOp) { virtualRefs.push_back(thisVirtualSymbolRefOp); });
+
+        for (auto thisVirtualSymbolRefOp : virtualRefs)
+        {
+            devirtualize(thisVirtualSymbolRefOp, symbolTable);
+        }
+
+        LLVM_DEBUG(llvm::dbgs() << "\n!! AFTER DEVIRTUALIZE DUMP: \n" << m << "\n";);
+    }
+
+  private:
+    void collectClasses(mlir::ModuleOp m, mlir::SymbolTable &symbolTable)
+    {
+        // instantiated classes and their bases: ts.New (stack instances, no GC) and ts.GCNewExplicitlyTyped (heap
+        // instances with typed GC)
+        m.walk([&](mlir::Operation *op) {
+            if (isa<mlir_ts::NewOp>(op) || isa<mlir_ts::GCNewExplicitlyTypedOp>(op))
+            {
+                markInstantiated(op->getResult(0).getType(), symbolTable);
+            }
+        });
+    }
+
+    void markInstantiated(mlir::Type type, mlir::SymbolTable &symbolTable)
+    {
+        if (auto classType = type.dyn_cast<mlir_ts::ClassType>())
+        {
+            registerClass(classType.getName().getValue(), classType.getStorageType(), symbolTable).instantiated = true;
+        }
+    }
+
+    ClassVTableInfo &registerClass(mlir::StringRef name, mlir::Type storageType, mlir::SymbolTable &symbolTable)
+    {
+        auto it = classes.find(name);
+        if (it != classes.end())
+        {
+            return it->second;
+        }
+
+        ClassVTableInfo info{};
+        if (auto classStorageType = storageType.dyn_cast_or_null<mlir_ts::ClassStorageType>())
+        {
+            if (classStorageType.size() > 0)
+            {
+                // base class is stored as first field with name of base class
+                auto fieldInfo = classStorageType.getFieldInfo(0);
+                if (auto baseStorageType = fieldInfo.type.dyn_cast<mlir_ts::ClassStorageType>())
+                {
+                    auto fieldName = fieldInfo.id.dyn_cast_or_null<mlir::StringAttr>();
+                    if (fieldName && fieldName.getValue() == baseStorageType.getName().getValue())
+                    {
+                        info.baseName = baseStorageType.getName().getValue();
+                        registerClass(info.baseName, baseStorageType, symbolTable);
+                    }
+                }
+            }
+        }
+
+        std::string vtableName(name);
+        vtableName += ".";
+        vtableName += VTABLE_NAME;
+        if (auto vtableGlobal = symbolTable.lookup<mlir_ts::GlobalOp>(vtableName))
+        {
+            info.vtableGlobal = vtableGlobal;
+            readVTableSlots(vtableGlobal, info.slots);
+        }
+
+        info.external = isExternalVTable(info.vtableGlobal);
+
+        return classes[name] = info;
+    }
+
+    static bool isExternalVTable(mlir_ts::GlobalOp vtableGlobal)
+    {
+        // declared class has no vtable (or external one without initializer)
+        if (!vtableGlobal || !vtableGlobal.getInitializerBlock())
+        {
+            return true;
+        }
+
+        if (auto linkageAttr = vtableGlobal->getAttrOfType<mlir::StringAttr>("Linkage"))
+        {
+            if (linkageAttr.getValue() == "External")
+            {
+                return true;
+            }
+        }
+
+        return vtableGlobal->hasAttr("import") || vtableGlobal->hasAttr("export");
+    }
+
+    void readVTableSlots(mlir_ts::GlobalOp vtableGlobal, llvm::SmallVector<mlir::FlatSymbolRefAttr> &slots)
+    {
+        auto *block = vtableGlobal.getInitializerBlock();
+        if (!block)
+        {
+            return;
+        }
+
+        auto resultOp = dyn_cast<mlir_ts::GlobalResultOp>(block->getTerminator());
+        if (!resultOp || resultOp.getResults().size() != 1)
+        {
+            return;
+        }
+
+        // vtable is built as chain of InsertPropertyOp on top of UndefOp
+        auto value = resultOp.getResults().front();
+        while (auto insertPropertyOp = value.getDefiningOp<mlir_ts::InsertPropertyOp>())
+        {
+            auto position = insertPropertyOp.getPosition();
+            if (position.size() == 1 && position.front() >= 0)
+            {
+                auto index = static_cast<size_t>(position.front());
+                if (slots.size() <= index)
+                {
+                    slots.resize(index + 1);
+                }
+
+                if (!slots[index])
+                {
+                    if (auto symbolRefOp = insertPropertyOp.getValue().getDefiningOp<mlir_ts::SymbolRefOp>())
+                    {
+                        slots[index] = symbolRefOp.getIdentifierAttr();
+                    }
+                }
+            }
+
+            value = insertPropertyOp.getObject();
+        }
+    }
+
+    bool isSubClassOf(mlir::StringRef name, mlir::StringRef baseName)
+    {
+        while (!name.empty())
+        {
+            if (name == baseName)
+            {
+                return true;
+            }
+
+            auto it = classes.find(name);
+            if (it == classes.end())
+            {
+                return false;
+            }
+
+            name = it->second.baseName;
+        }
+
+        return false;
+    }
+
+    // instances of class from shared library can be created by subclasses which are not visible here
+    bool isExternalHierarchy(mlir::StringRef name)
+    {
+        while (!name.empty())
+        {
+            auto it = classes.find(name);
+            if (it == classes.end() || it->second.external)
+            {
+                return true;
+            }
+
+            name = it->second.baseName;
+        }
+
+        return false;
+    }
+
+    // returns false if any of instantiated subclasses can't be resolved
+    bool getTargets(mlir::StringRef staticClassName, int index, mlir::SymbolTable &symbolTable,
+                    llvm::SmallVector<DevirtualizeTarget> &targets)
+    {
+        if (isExternalHierarchy(staticClassName))
+        {
+            return false;
+        }
+
+        for (auto &classInfo : classes)
+        {
+            if (!classInfo.second.instantiated || !isSubClassOf(classInfo.first(), staticClassName))
+            {
+                continue;
+            }
+
+            auto &slots = classInfo.second.slots;
+            if (index < 0 || static_cast<size_t>(index) >= slots.size() || !slots[index])
+            {
+                return false;
+            }
+
+            auto funcOp = symbolTable.lookup<mlir_ts::FuncOp>(slots[index].getValue());
+            if (!funcOp || funcOp.isExternal())
+            {
+                return false;
+            }
+
+            targets.push_back({classInfo.first(), funcOp});
+        }
+
+        return !targets.empty();
+    }
+
+    static bool isCompatibleTarget(mlir_ts::BoundFunctionType boundFuncType, mlir_ts::FuncOp funcOp)
+    {
+        // only "this" parameter can be different (override is defined in sub class)
+        auto funcType = funcOp.getFunctionType();
+        if (funcType.getNumInputs() != boundFuncType.getInputs().size() || funcType.getNumInputs() == 0 ||
+            funcType.getResults() != boundFuncType.getResults())
+        {
+            return false;
+        }
+
+        return funcType.getInputs().drop_front() == boundFuncType.getInputs().drop_front() &&
+               funcType.getInput(0).isa<mlir_ts::ClassType>();
+    }
+
+    void devirtualize(mlir_ts::ThisVirtualSymbolRefOp thisVirtualSymbolRefOp, mlir::SymbolTable &symbolTable)
+    {
+        auto classType = thisVirtualSymbolRefOp.getThisVal().getType().dyn_cast<mlir_ts::ClassType>();
+        auto boundFuncType = thisVirtualSymbolRefOp.getType().dyn_cast<mlir_ts::BoundFunctionType>();
+        if (!classType || !boundFuncType)
+        {
+            return;
+        }
+
+        llvm::SmallVector<DevirtualizeTarget> targets;
+        if (!getTargets(classType.getName().getValue(), thisVirtualSymbolRefOp.getIndex(), symbolTable, targets))
+        {
+            return;
+        }
+
+        if (llvm::any_of(targets, [&](auto &target) { return !isCompatibleTarget(boundFuncType, target.funcOp); }))
+        {
+            return;
+        }
+
+        auto singleTarget = llvm::all_of(targets, [&](auto &target) { return target.funcOp == targets.front().funcOp; });
+        if (!singleTarget && targets.size() > MAX_SPECULATIVE_TARGETS)
+        {
+            return;
+        }
+
+        LLVM_DEBUG(llvm::dbgs() << "\n!! devirtualize: " << thisVirtualSymbolRefOp << " targets: " << targets.size()
+                                << (singleTarget ? " (direct)" : " (speculative)") << "\n";);
+
+        // rewrite calls, ts.CallIndirect(ts.GetMethod(%bound), ts.GetThis(%bound), ...)
+        llvm::SmallVector<mlir_ts::CallIndirectOp> calls;
+        for (auto *user : thisVirtualSymbolRefOp->getUsers())
+        {
+            if (auto getMethodOp = dyn_cast<mlir_ts::GetMethodOp>(user))
+            {
+                for (auto *methodUser : getMethodOp->getUsers())
+                {
+                    if (auto callIndirectOp = dyn_cast<mlir_ts::CallIndirectOp>(methodUser))
+                    {
+                        if (callIndirectOp.getCallee() == getMethodOp.getResult() &&
+                            !callIndirectOp.getArgOperands().empty())
+                        {
+                            calls.push_back(callIndirectOp);
+                        }
+                    }
+                }
+            }
+        }
+
+        for (auto callIndirectOp : calls)
+        {
+            mlir::OpBuilder builder(callIndirectOp);
+            mlir::SmallVector<mlir::Value> results;
+            if (singleTarget)
+            {
+                results = createDirectCall(builder, callIndirectOp, targets.front().funcOp);
+            }
+            else
+            {
+                results = createGuardedCall(builder, callIndirectOp, thisVirtualSymbolRefOp.getVtable(), targets,
+                                            symbolTable);
+            }
+
+            callIndirectOp->replaceAllUsesWith(results);
+            callIndirectOp->erase();
+        }
+    }
+
+    mlir::SmallVector<mlir::Value> createDirectCall(mlir::OpBuilder &builder, mlir_ts::CallIndirectOp callIndirectOp,
+                                                    mlir_ts::FuncOp funcOp)
+    {
+        auto loc = callIndirectOp->getLoc();
+
+        mlir::SmallVector<mlir::Value> args(callIndirectOp.getArgOperands().begin(),
+                                            callIndirectOp.getArgOperands().end());
+
+        // override receives "this" of own class
+        auto thisType = funcOp.getFunctionType().getInput(0);
+        if (args.front().getType() != thisType)
+        {
+            args[0] = builder.create<mlir_ts::CastOp>(loc, thisType, args.front());
+        }
+
+        auto callOp = builder.create<mlir_ts::CallOp>(loc, funcOp.getName(), callIndirectOp.getResultTypes(), args);
+        return mlir::SmallVector<mlir::Value>(callOp.getResults().begin(), callOp.getResults().end());
+    }
+
+    mlir::SmallVector<mlir::Value> createGuardedCall(mlir::OpBuilder &builder, mlir_ts::CallIndirectOp callIndirectOp,
+                                                     mlir::Value vtable, llvm::ArrayRef<DevirtualizeTarget> targets,
+                                                     mlir::SymbolTable &symbolTable)
+    {
+        auto loc = callIndirectOp->getLoc();
+
+        if (targets.empty())
+        {
+            // class is not known, fall back to virtual call
+            auto *clonedOp = builder.clone(*callIndirectOp);
+            return mlir::SmallVector<mlir::Value>(clonedOp->getResults().begin(), clonedOp->getResults().end());
+        }
+
+        auto &target = targets.front();
+        auto vtableGlobal = classes[target.className].vtableGlobal;
+
+        // if (this.vtbl === &Class.vtbl) Class.method(this, ...) else ...
+        auto opaqueType = mlir_ts::OpaqueType::get(builder.getContext());
+        auto vtableAddress = builder.create<mlir_ts::AddressOfOp>(
+            loc, mlir_ts::RefType::get(vtableGlobal.getType()), vtableGlobal.getSymName(), ::mlir::IntegerAttr());
+        auto vtableAddressOpaque = builder.create<mlir_ts::CastOp>(loc, opaqueType, vtableAddress);
+        mlir::Value vtableOpaque = vtable;
+        if (vtableOpaque.getType() != opaqueType)
+        {
+            vtableOpaque = builder.create<mlir_ts::CastOp>(loc, opaqueType, vtable);
+        }
+
+        auto condition = builder.create<mlir_ts::LogicalBinaryOp>(
+            loc, mlir_ts::BooleanType::get(builder.getContext()),
+            builder.getI32IntegerAttr((int)SyntaxKind::EqualsEqualsEqualsToken), vtableOpaque, vtableAddressOpaque);
+
+        auto resultTypes = callIndirectOp.getResultTypes();
+        auto ifOp = builder.create<mlir_ts::IfOp>(loc, resultTypes, condition, true);
+
+        {
+            mlir::OpBuilder::InsertionGuard guard(builder);
+
+            builder.setInsertionPointToStart(&ifOp.getThenRegion().back());
+            auto directResults = createDirectCall(builder, callIndirectOp, target.funcOp);
+            if (!resultTypes.empty())
+            {
+                builder.create<mlir_ts::ResultOp>(loc, directResults);
+            }
+
+            builder.setInsertionPointToStart(&ifOp.getElseRegion().back());
+            auto elseResults = createGuardedCall(builder, callIndirectOp, vtable, targets.drop_front(), symbolTable);
+            if (!resultTypes.empty())
+            {
+                builder.create<mlir_ts::ResultOp>(loc, elseResults);
+            }
+        }
+
+        return mlir::SmallVector<mlir::Value>(ifOp.getResults().begin(), ifOp.getResults().end());
+    }
+};
+
+} // end anonymous namespace
+
+std::unique_ptr<mlir::Pass> mlir_ts::createDevirtualizePass()
+{
+    return std::make_unique<DevirtualizePass>();
+}
@@ -0,0 +1,357 @@
+#define DEBUG_TYPE "pass"
+
+#include "mlir/Pass/Pass.h"
+
+#include "TypeScript/Defines.h"
+#include "TypeScript/TypeScriptDialect.h"
+#include "TypeScript/TypeScriptOps.h"
+#include "TypeScript/Passes.h"
+#include "TypeScript/ModulePass.h"
+
+#include "mlir/IR/Dominance.h"
+#include "mlir/IR/SymbolTable.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace mlir_ts = mlir::typescript;
+
+namespace
+{
+
+// Escape analysis: allocation (class instance, boxed object) which never leaves its function is allocated in stack.
+// Value is not escaping if it is used only for
+//  - access to fields (loaded or stored, but not stored itself into other object)
+//  - stores into local (not captured) variables, loads from such variables are followed as the same value
+//  - casts to other class types (base classes)
+//  - comparisons
+//  - passing into functions which do not let the parameter escape (computed for all functions of the module)
+// Any other use (return, capture, store into heap, indirect or external call etc.) is escape.
+// Scalar replacement of stack instances is done by LLVM (SROA) as allocas are placed at function entry.
+class EscapeAnalysisPass : public mlir::PassWrapper<EscapeAnalysisPass, ModulePass>
+{
+    // function -> does parameter escape
+    llvm::DenseMap<mlir::Operation *, llvm::SmallVector<bool>> paramEscapes;
+
+  public:
+    MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(EscapeAnalysisPass)
+
+    void runOnModule() override
+    {
+        auto m = getModule();
+
+        mlir::SymbolTable symbolTable(m);
+
+        llvm::SmallVector<mlir_ts::FuncOp> funcs;
+        m.walk([&](mlir_ts::FuncOp funcOp) {
+            if (!funcOp.isExternal())
+            {
+                funcs.push_back(funcOp);
+            }
+        });
+
+        computeParamEscapes(funcs, symbolTable);
+
+        for (auto funcOp : funcs)
+        {
+            allocateInStack(funcOp, symbolTable);
+        }
+
+        LLVM_DEBUG(llvm::dbgs() << "\n!! AFTER ESCAPE ANALYSIS DUMP: \n" << m << "\n";);
+    }
+
+  private:
+    void computeParamEscapes(llvm::ArrayRef<mlir_ts::FuncOp> funcs, mlir::SymbolTable &symbolTable)
+    {
+        paramEscapes.clear();
+
+        // optimistic start (no parameter escapes), then parameters are marked as escaping until fixed point, to support
+        // recursive calls
+        for (auto funcOp : funcs)
+        {
+            paramEscapes[funcOp].assign(funcOp.getNumArguments(), false);
+        }
+
+        auto changed = true;
+        while (changed)
+        {
+            changed = false;
+            for (auto funcOp : funcs)
+            {
+                mlir::DominanceInfo dom(funcOp);
+                auto &entryBlock = funcOp.getBody().front();
+                for (auto index = 0U; index < entryBlock.getNumArguments(); index++)
+                {
+                    if (paramEscapes[funcOp][index])
+                    {
+                        continue;
+                    }
+
+                    if (escapes(entryBlock.getArgument(index), funcOp, dom, symbolTable))
+                    {
+                        paramEscapes[funcOp][index] = true;
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+
+    void allocateInStack(mlir_ts::FuncOp funcOp, mlir::SymbolTable &symbolTable)
+    {
+        llvm::SmallVector<mlir::Operation *> allocs;
+        for (auto &block : funcOp.getBody())
+        {
+            for (auto &op : block)
+            {
+                if (auto newOp = dyn_cast<mlir_ts::NewOp>(op))
+                {
+                    if (!newOp.getStackAlloc().has_value() || !newOp.getStackAlloc().value())
+                    {
+                        allocs.push_back(newOp);
+                    }
+                }
+                else if (isa<mlir_ts::GCNewExplicitlyTypedOp>(op))
+                {
+                    allocs.push_back(&op);
+                }
+            }
+        }
+
+        if (allocs.empty())
+        {
+            return;
+        }
+
+        mlir::DominanceInfo dom(funcOp);
+        for (auto *allocOp : allocs)
+        {
+            auto instance = allocOp->getResult(0);
+            if (escapes(instance, funcOp, dom, symbolTable))
+            {
+                continue;
+            }
+
+            LLVM_DEBUG(llvm::dbgs() << "\n!! allocate in stack: " << *allocOp << "\n";);
+
+            mlir::OpBuilder builder(allocOp);
+            auto newOp = builder.create<mlir_ts::NewOp>(allocOp->getLoc(), instance.getType(), builder.getBoolAttr(true));
+            // instance is not used after allocation is executed again, so one stack slot can be used in loop
+            newOp->setAttr(REUSE_STACK_SLOT_ATTR_NAME, builder.getUnitAttr());
+            instance.replaceAllUsesWith(newOp.getResult());
+            allocOp->erase();
+        }
+    }
+
+    bool isFieldRefEscaping(mlir_ts::PropertyRefOp propertyRefOp)
+    {
+        for (auto *user : propertyRefOp->getUsers())
+        {
+            if (isa<mlir_ts::LoadOp>(user))
+            {
+                continue;
+            }
+
+            if (auto storeOp = dyn_cast<mlir_ts::StoreOp>(user))
+            {
+                if (storeOp.getReference() == propertyRefOp.getResult() && storeOp.getValue() != propertyRefOp.getResult())
+                {
+                    continue;
+                }
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    bool isCallParamEscaping(mlir_ts::CallOp callOp, unsigned operandIndex, mlir::SymbolTable &symbolTable)
+    {
+        auto calleeOp = symbolTable.lookup<mlir_ts::FuncOp>(callOp.getCallee());
+        if (!calleeOp)
+        {
+            return true;
+        }
+
+        auto it = paramEscapes.find(calleeOp);
+        if (it == paramEscapes.end() || operandIndex >= it->second.size())
+        {
+            return true;
+        }
+
+        return it->second[operandIndex];
+    }
+
+    bool escapes(mlir::Value value, mlir_ts::FuncOp funcOp, mlir::DominanceInfo &dom, mlir::SymbolTable &symbolTable)
+    {
+        llvm::SmallVector<mlir::Value> worklist{value};
+        llvm::DenseSet<mlir::Value> aliases;
+
+        // local variables which hold the value and stores of the value into them
+        llvm::DenseMap<mlir::Operation *, llvm::SmallVector<mlir::Operation *>> variableStores;
+
+        auto trackVariable = [&](mlir_ts::VariableOp variableOp, mlir::Operation *storeOp) {
+            if (variableOp->getParentOp() != funcOp ||
+                (variableOp.getCaptured().has_value() && variableOp.getCaptured().value()))
+            {
+                return false;
+            }
+
+            auto inserted = !variableStores.count(variableOp);
+            variableStores[variableOp].push_back(storeOp);
+            if (!inserted)
+            {
+                return true;
+            }
+
+            for (auto *user : variableOp->getUsers())
+            {
+                if (auto loadOp = dyn_cast<mlir_ts::LoadOp>(user))
+                {
+                    worklist.push_back(loadOp.getResult());
+                    continue;
+                }
+
+                if (auto userStoreOp = dyn_cast<mlir_ts::StoreOp>(user))
+                {
+                    if (userStoreOp.getReference() == variableOp.getReference() &&
+                        userStoreOp.getValue() != variableOp.getReference())
+                    {
+                        continue;
+                    }
+                }
+
+                return false;
+            }
+
+            return true;
+        };
+
+        while (!worklist.empty())
+        {
+            auto current = worklist.pop_back_val();
+            if (!aliases.insert(current).second)
+            {
+                continue;
+            }
+
+            for (auto &use : current.getUses())
+            {
+                auto *user = use.getOwner();
+
+                // nested regions (async etc.) can outlive the frame
+                if (user->getParentOp() != funcOp)
+                {
+                    return true;
+                }
+
+                if (auto propertyRefOp = dyn_cast<mlir_ts::PropertyRefOp>(user))
+                {
+                    if (isFieldRefEscaping(propertyRefOp))
+                    {
+                        return true;
+                    }
+
+                    continue;
+                }
+
+                if (auto storeOp = dyn_cast<mlir_ts::StoreOp>(user))
+                {
+                    if (storeOp.getReference() == current && storeOp.getValue() != current)
+                    {
+                        // store into boxed value itself
+                        continue;
+                    }
+
+                    auto variableOp = storeOp.getReference().getDefiningOp<mlir_ts::VariableOp>();
+                    if (variableOp && trackVariable(variableOp, storeOp))
+                    {
+                        continue;
+                    }
+
+                    return true;
+                }
+
+                if (auto loadOp = dyn_cast<mlir_ts::LoadOp>(user))
+                {
+                    // loading boxed value makes copy
+                    continue;
+                }
+
+                if (auto variableOp = dyn_cast<mlir_ts::VariableOp>(user))
+                {
+                    if (trackVariable(variableOp, variableOp))
+                    {
+                        continue;
+                    }
+
+                    return true;
+                }
+
+                if (auto castOp = dyn_cast<mlir_ts::CastOp>(user))
+                {
+                    if (castOp.getType().isa<mlir_ts::ClassType>())
+                    {
+                        worklist.push_back(castOp.getRes());
+                        continue;
+                    }
+
+                    return true;
+                }
+
+                if (isa<mlir_ts::LogicalBinaryOp>(user))
+                {
+                    continue;
+                }
+
+                if (auto callOp = dyn_cast<mlir_ts::CallOp>(user))
+                {
+                    if (!isCallParamEscaping(callOp, use.getOperandNumber(), symbolTable))
+                    {
+                        continue;
+                    }
+
+                    return true;
+                }
+
+                return true;
+            }
+        }
+
+        // stack instance is reused when allocation is executed again (in loop), so each load from variable must see the
+        // value stored after the last allocation
+        for (auto &variableStore : variableStores)
+        {
+            for (auto *user : variableStore.first->getUsers())
+            {
+                auto loadOp = dyn_cast<mlir_ts::LoadOp>(user);
+                if (!loadOp)
+                {
+                    continue;
+                }
+
+                auto dominated = llvm::any_of(variableStore.second, [&](mlir::Operation *storeOp) {
+                    return dom.properlyDominates(storeOp, loadOp);
+                });
+
+                if (!dominated)
+                {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+};
+
+} // end anonymous namespace
+
+std::unique_ptr<mlir::Pass> mlir_ts::createEscapeAnalysisPass()
+{
+    return std::make_unique<EscapeAnalysisPass>();
+}
@@ -0,0 +1,469 @@
+#define DEBUG_TYPE "pass"
+
+#include "mlir/Pass/Pass.h"
+
+#include "TypeScript/Config.h"
+#include "TypeScript/Passes.h"
+#include "TypeScript/ModulePass.h"
+
+#include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Transforms/RegionUtils.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace mlir_ts = mlir::typescript;
+namespace LLVM = mlir::LLVM;
+
+namespace
+{
+
+enum MemoryAccess
+{
+    NoAccess = 0,
+    ReadAccess = 1,
+    WriteAccess = 2,
+    ReadWriteAccess = ReadAccess | WriteAccess
+};
+
+struct FunctionAttrsInfo
+{
+    bool mayUnwind;
+    bool willReturn;
+    int memory;
+};
+
+// Function attributes inference on LLVM dialect (after lowering all exceptions are explicit: invoke, resume and calls
+// of throw functions of runtime). Computed bottom-up for all functions of the module (fixed point, so recursion is
+// supported):
+//  - nounwind: function has no resume and calls only functions which can't unwind (invoke catches exception)
+//  - memory(none)/memory(read): function does not write (read) memory except own allocas
+//  - willreturn: function has no loops and calls only functions which return
+// Invoke of function which can't unwind is replaced with call. When function has no invokes anymore landing pads
+// are removed, together with personality and 'noinline' which is added for functions with personality.
+class FunctionAttrsPass : public mlir::PassWrapper<FunctionAttrsPass, ModulePass>
+{
+    llvm::DenseMap<mlir::Operation *, FunctionAttrsInfo> infos;
+
+  public:
+    MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(FunctionAttrsPass)
+
+    void runOnModule() override
+    {
+        auto m = getModule();
+
+        mlir::SymbolTable symbolTable(m);
+
+        llvm::SmallVector<LLVM::LLVMFuncOp> funcs;
+        m.walk([&](LLVM::LLVMFuncOp funcOp) {
+            if (funcOp.isExternal())
+            {
+                return;
+            }
+
+            // optimistic start, moves to conservative side till fixed point
+            infos[funcOp] = {false, false, NoAccess};
+            funcs.push_back(funcOp);
+        });
+
+        computeAttrs(funcs, symbolTable);
+
+        for (auto funcOp : funcs)
+        {
+            removeUnwindEdges(funcOp, symbolTable);
+            setAttrs(funcOp);
+        }
+    }
+
+    static FunctionAttrsInfo getExternalInfo(StringRef name)
+    {
+        // C runtime and GC functions used by generated code
+        static llvm::StringMap<FunctionAttrsInfo> knownFunctions{
+            {"strlen", {false, true, ReadAccess}},
+            {"strcmp", {false, true, ReadAccess}},
+            {"strncmp", {false, true, ReadAccess}},
+            {"memcmp", {false, true, ReadAccess}},
+            {"atoi", {false, true, ReadAccess}},
+            {"atof", {false, true, ReadAccess}},
+            {"strcpy", {false, true, ReadWriteAccess}},
+            {"strcat", {false, true, ReadWriteAccess}},
+            {"memset", {false, true, ReadWriteAccess}},
+            {"memcpy", {false, true, ReadWriteAccess}},
+            {"memmove", {false, true, ReadWriteAccess}},
+            {"malloc", {false, true, ReadWriteAccess}},
+            {"calloc", {false, true, ReadWriteAccess}},
+            {"realloc", {false, true, ReadWriteAccess}},
+            {"free", {false, true, ReadWriteAccess}},
+            {"GC_init", {false, true, ReadWriteAccess}},
+            {"GC_malloc", {false, true, ReadWriteAccess}},
+            {"GC_malloc_atomic", {false, true, ReadWriteAccess}},
+            {"GC_malloc_explicitly_typed", {false, true, ReadWriteAccess}},
+            {"GC_make_descriptor", {false, true, ReadWriteAccess}},
+            {"GC_memalign", {false, true, ReadWriteAccess}},
+            {"GC_realloc", {false, true, ReadWriteAccess}},
+            {"GC_free", {false, true, ReadWriteAccess}},
+            {"GC_get_heap_size", {false, true, ReadAccess}},
+            {"GC_size", {false, true, ReadAccess}},
+            {"__cxa_allocate_exception", {false, true, ReadWriteAccess}},
+            {"ts_int32_to_string", {false, true, ReadWriteAccess}},
+            {"ts_int64_to_string", {false, true, ReadWriteAccess}},
+            {"ts_uint64_to_string", {false, true, ReadWriteAccess}},
+            {"ts_number_to_string", {false, true, ReadWriteAccess}},
+            {"ts_parse_int", {false, true, ReadAccess}},
+            {"ts_parse_float", {false, true, ReadWriteAccess}},
+            {"ts_string_to_number", {false, true, ReadWriteAccess}},
+            {"puts", {false, false, ReadWriteAccess}},
+            {"printf", {false, false, ReadWriteAccess}},
+            {"_assert", {false, false, ReadWriteAccess}},
+            {"abort", {false, false, ReadWriteAccess}},
+            {"exit", {false, false, ReadWriteAccess}},
+        };
+
+        auto it = knownFunctions.find(name);
+        if (it != knownFunctions.end())
+        {
+            return it->second;
+        }
+
+        // unknown external function can throw
+        return {true, false, ReadWriteAccess};
+    }
+
+    FunctionAttrsInfo getCalleeInfo(std::optional<StringRef> callee, mlir::SymbolTable &symbolTable)
+    {
+        if (!callee.has_value())
+        {
+            // indirect call
+            return {true, false, ReadWriteAccess};
+        }
+
+        auto funcOp = symbolTable.lookup<LLVM::LLVMFuncOp>(callee.value());
+        if (!funcOp)
+        {
+            return {true, false, ReadWriteAccess};
+        }
+
+        auto it = infos.find(funcOp);
+        if (it != infos.end())
+        {
+            return it->second;
+        }
+
+        auto info = getExternalInfo(callee.value());
+        if (hasPassthrough(funcOp, "nounwind"))
+        {
+            info.mayUnwind = false;
+        }
+
+        return info;
+    }
+
+    static bool hasPassthrough(LLVM::LLVMFuncOp funcOp, StringRef name)
+    {
+        auto passthrough = funcOp.getPassthrough();
+        if (!passthrough.has_value())
+        {
+            return false;
+        }
+
+        return llvm::any_of(passthrough.value(), [&](mlir::Attribute attr) {
+            auto strAttr = attr.dyn_cast<mlir::StringAttr>();
+            return strAttr && strAttr.getValue() == name;
+        });
+    }
+
+    static bool isLocalMemory(mlir::Value ptr)
+    {
+        while (ptr)
+        {
+            if (ptr.getDefiningOp<LLVM::AllocaOp>())
+            {
+                return true;
+            }
+
+            if (auto gepOp = ptr.getDefiningOp<LLVM::GEPOp>())
+            {
+                ptr = gepOp.getBase();
+                continue;
+            }
+
+            if (auto bitcastOp = ptr.getDefiningOp<LLVM::BitcastOp>())
+            {
+                ptr = bitcastOp.getArg();
+                continue;
+            }
+
+            break;
+        }
+
+        return false;
+    }
+
+    static int getMemoryAccess(mlir::Operation *op)
+    {
+        if (isa<LLVM::AllocaOp, LLVM::DbgDeclareOp, LLVM::DbgValueOp>(op) || mlir::isMemoryEffectFree(op))
+        {
+            return NoAccess;
+        }
+
+        auto effectInterface = dyn_cast<mlir::MemoryEffectOpInterface>(op);
+        if (!effectInterface)
+        {
+            return ReadWriteAccess;
+        }
+
+        SmallVector<mlir::MemoryEffects::EffectInstance> effects;
+        effectInterface.getEffects(effects);
+
+        auto access = (int)NoAccess;
+        for (auto &effect : effects)
+        {
+            if (isa<mlir::MemoryEffects::Allocate>(effect.getEffect()))
+            {
+                continue;
+            }
+
+            if (isLocalMemory(effect.getValue()))
+            {
+                continue;
+            }
+
+            access |= isa<mlir::MemoryEffects::Read>(effect.getEffect()) ? ReadAccess : WriteAccess;
+        }
+
+        return access;
+    }
+
+    static bool hasLoops(LLVM::LLVMFuncOp funcOp)
+    {
+        // back edge in DFS over blocks
+        llvm::DenseSet<mlir::Block *> visited;
+        llvm::DenseSet<mlir::Block *> onStack;
+        SmallVector<std::pair<mlir::Block *, unsigned>> stack;
+
+        auto *entry = &funcOp.getBody().front();
+        stack.push_back({entry, 0});
+        visited.insert(entry);
+        onStack.insert(entry);
+        while (!stack.empty())
+        {
+            auto &[block, index] = stack.back();
+            if (index < block->getNumSuccessors())
+            {
+                auto *succ = block->getSuccessor(index++);
+                if (onStack.contains(succ))
+                {
+                    return true;
+                }
+
+                if (visited.insert(succ).second)
+                {
+                    onStack.insert(succ);
+                    stack.push_back({succ, 0});
+                }
+
+                continue;
+            }
+
+            onStack.erase(block);
+            stack.pop_back();
+        }
+
+        return false;
+    }
+
+    FunctionAttrsInfo computeInfo(LLVM::LLVMFuncOp funcOp, bool acyclic, mlir::SymbolTable &symbolTable)
+    {
+        FunctionAttrsInfo info{false, acyclic, NoAccess};
+        funcOp.walk([&](mlir::Operation *op) {
+            if (isa<LLVM::ResumeOp>(op))
+            {
+                info.mayUnwind = true;
+                return;
+            }
+
+            if (isa<LLVM::InlineAsmOp>(op))
+            {
+                info.mayUnwind = true;
+                info.willReturn = false;
+                info.memory = ReadWriteAccess;
+                return;
+            }
+
+            if (auto callOp = dyn_cast<LLVM::CallOp>(op))
+            {
+                auto calleeInfo = getCalleeInfo(callOp.getCallee(), symbolTable);
+                info.mayUnwind |= calleeInfo.mayUnwind;
+                info.willReturn &= calleeInfo.willReturn;
+                info.memory |= calleeInfo.memory;
+                return;
+            }
+
+            if (auto invokeOp = dyn_cast<LLVM::InvokeOp>(op))
+            {
+                // exception is caught by landing pad
+                auto calleeInfo = getCalleeInfo(invokeOp.getCallee(), symbolTable);
+                info.willReturn &= calleeInfo.willReturn;
+                info.memory |= calleeInfo.memory;
+                return;
+            }
+
+            info.memory |= getMemoryAccess(op);
+        });
+
+        return info;
+    }
+
+    void computeAttrs(llvm::SmallVector<LLVM::LLVMFuncOp> &funcs, mlir::SymbolTable &symbolTable)
+    {
+        llvm::DenseMap<mlir::Operation *, bool> acyclic;
+        for (auto funcOp : funcs)
+        {
+            // willreturn goes from 'false' to 'true', so recursive functions stay 'false'
+            acyclic[funcOp] = !hasLoops(funcOp);
+        }
+
+        auto changed = true;
+        while (changed)
+        {
+            changed = false;
+            for (auto funcOp : funcs)
+            {
+                auto info = computeInfo(funcOp, acyclic[funcOp], symbolTable);
+                auto &current = infos[funcOp];
+                if (info.mayUnwind != current.mayUnwind || info.willReturn != current.willReturn ||
+                    info.memory != current.memory)
+                {
+                    current = info;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    void removeUnwindEdges(LLVM::LLVMFuncOp funcOp, mlir::SymbolTable &symbolTable)
+    {
+        SmallVector<LLVM::InvokeOp> invokes;
+        funcOp.walk([&](LLVM::InvokeOp invokeOp) { invokes.push_back(invokeOp); });
+        if (invokes.empty())
+        {
+            return;
+        }
+
+        mlir::IRRewriter rewriter(funcOp.getContext());
+        auto replaced = 0;
+        for (auto invokeOp : invokes)
+        {
+            if (!invokeOp.getCallee().has_value())
+            {
+                continue;
+            }
+
+            auto calleeFuncOp = symbolTable.lookup<LLVM::LLVMFuncOp>(invokeOp.getCallee().value());
+            if (!calleeFuncOp || calleeFuncOp.isVarArg() ||
+                getCalleeInfo(invokeOp.getCallee(), symbolTable).mayUnwind)
+            {
+                continue;
+            }
+
+            LLVM_DEBUG(llvm::dbgs() << "\n!! invoke -> call: " << invokeOp << "\n";);
+
+            rewriter.setInsertionPoint(invokeOp);
+            auto callOp = rewriter.create<LLVM::CallOp>(invokeOp.getLoc(), calleeFuncOp, invokeOp.getCalleeOperands());
+            rewriter.create<LLVM::BrOp>(invokeOp.getLoc(), invokeOp.getNormalDestOperands(), invokeOp.getNormalDest());
+            rewriter.replaceOp(invokeOp, callOp.getResults());
+            replaced++;
+        }
+
+        if (replaced == 0)
+        {
+            return;
+        }
+
+        // landing pads are not reachable anymore
+        (void)mlir::eraseUnreachableBlocks(rewriter, funcOp->getRegions());
+
+        auto hasLandingPads = false;
+        funcOp.walk([&](LLVM::LandingpadOp) { hasLandingPads = true; });
+        if (hasLandingPads)
+        {
+            return;
+        }
+
+        funcOp.removePersonalityAttr();
+
+#ifndef DISABLE_OPT
+        // 'noinline' was added because of personality, keep it if it is requested by decorator
+        if (!funcOp->hasAttr("noinline") && funcOp.getPassthrough().has_value())
+        {
+            SmallVector<mlir::Attribute> passthrough;
+            for (auto attr : funcOp.getPassthrough().value())
+            {
+                auto strAttr = attr.dyn_cast<mlir::StringAttr>();
+                if (!strAttr || strAttr.getValue() != "noinline")
+                {
+                    passthrough.push_back(attr);
+                }
+            }
+
+            funcOp.setPassthroughAttr(mlir::ArrayAttr::get(funcOp.getContext(), passthrough));
+        }
+#endif
+    }
+
+    void setAttrs(LLVM::LLVMFuncOp funcOp)
+    {
+        auto &info = infos[funcOp];
+
+        LLVM_DEBUG(llvm::dbgs() << "\n!! function attrs: " << funcOp.getName() << " nounwind: " << !info.mayUnwind
+                                << " willreturn: " << info.willReturn << " memory: " << info.memory << "\n";);
+
+        SmallVector<mlir::Attribute> passthrough;
+        if (funcOp.getPassthrough().has_value())
+        {
+            passthrough.append(funcOp.getPassthrough().value().begin(), funcOp.getPassthrough().value().end());
+        }
+
+        auto addPassthrough = [&](StringRef name) {
+            if (!hasPassthrough(funcOp, name))
+            {
+                passthrough.push_back(mlir::StringAttr::get(funcOp.getContext(), name));
+            }
+        };
+
+        if (!info.mayUnwind)
+        {
+            addPassthrough("nounwind");
+        }
+
+        if (info.willReturn)
+        {
+            addPassthrough("willreturn");
+        }
+
+        if (!passthrough.empty())
+        {
+            funcOp.setPassthroughAttr(mlir::ArrayAttr::get(funcOp.getContext(), passthrough));
+        }
+
+        if ((info.memory & WriteAccess) == 0 && !funcOp.getMemoryAttr())
+        {
+            auto modRef = info.memory == NoAccess ? LLVM::ModRefInfo::NoModRef : LLVM::ModRefInfo::Ref;
+            funcOp.setMemoryAttr(LLVM::MemoryEffectsAttr::get(funcOp.getContext(), modRef, modRef, modRef));
+        }
+    }
+};
+
+} // end anonymous namespace
+
+std::unique_ptr<mlir::Pass> mlir_ts::createFunctionAttrsPass()
+{
+    return std::make_unique<FunctionAttrsPass>();
+}
@@ -49,7 +49,7 @@ class GCPass : public mlir::PassWrapper<GCPass, ModulePass>
                 auto name = std::string(symbolAttr.getValue());
                 if (!funcOp.getBody().empty())
                 {
-                    if (name == "main")
+                    if (name == "main" || isTypeDescriptorConstructor(funcOp))
                     {
                         injectInit(funcOp);
                     }
@@ -164,9 +164,24 @@ class GCPass : public mlir::PassWrapper<GCPass, ModulePass>
         auto gcInitFuncOp = ch.getOrInsertFunction("GC_malloc_atomic", th.getFunctionType(th.getI8PtrType(), mlir::ArrayRef<mlir::Type>{th.getI64Type()}));
     }
 
+    // type descriptors of classes are created by global constructors, they run before main and GC must be
+    // initialized before GC_make_descriptor
+    bool isTypeDescriptorConstructor(LLVM::LLVMFuncOp funcOp)
+    {
+        auto result = funcOp.walk([](LLVM::CallOp callOp) {
+            auto callee = callOp.getCallee();
+            return callee.has_value() && callee.value() == "GC_make_descriptor" ? mlir::WalkResult::interrupt()
+                                                                                : mlir::WalkResult::advance();
+        });
+
+        return result.wasInterrupted();
+    }
+
+    // GC_init can be called more than once
     void injectInit(LLVM::LLVMFuncOp funcOp)
     {
         ConversionPatternRewriter rewriter(funcOp.getContext());
+        rewriter.setInsertionPointToStart(&funcOp.getBody().front());
 
         TypeHelper th(rewriter.getContext());
         LLVMCodeHelper ch(funcOp, rewriter, nullptr, tsContext.compileOptions);
@@ -0,0 +1,1009 @@
+#define DEBUG_TYPE "pass"
+
+#include "mlir/Pass/Pass.h"
+
+#include "TypeScript/Config.h"
+#include "TypeScript/TypeScriptDialect.h"
+#include "TypeScript/TypeScriptOps.h"
+#include "TypeScript/Passes.h"
+#include "TypeScript/ModulePass.h"
+
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "scanner_enums.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+namespace mlir_ts = mlir::typescript;
+
+namespace
+{
+
+// largest integer which 'number' represents exactly (and all integers below it)
+#ifdef NUMBER_F64
+const int64_t MaxSafeInteger = (int64_t(1) << 53);
+#else
+const int64_t MaxSafeInteger = (int64_t(1) << 24);
+#endif
+
+// variable which changes only by small steps (i++, i += 2) can't leave safe integer range in feasible time:
+// it needs more than 2^49 iterations, so such variables are widened to "counter" range instead of 'number'
+const int64_t MaxInductionStep = 16;
+
+// fixed point iterations before widening
+const int MaxIterationsBeforeWidening = 4;
+
+struct IntRange
+{
+    enum class State
+    {
+        Bottom,
+        Known,
+        Unknown
+    };
+
+    State state;
+    int64_t lo;
+    int64_t hi;
+
+    static IntRange bottom()
+    {
+        return {State::Bottom, 0, 0};
+    }
+
+    static IntRange unknown()
+    {
+        return {State::Unknown, 0, 0};
+    }
+
+    static IntRange of(int64_t lo, int64_t hi)
+    {
+        if (lo < -MaxSafeInteger || hi > MaxSafeInteger)
+        {
+            return unknown();
+        }
+
+        return {State::Known, lo, hi};
+    }
+
+    bool isBottom() const
+    {
+        return state == State::Bottom;
+    }
+
+    bool isKnown() const
+    {
+        return state == State::Known;
+    }
+
+    bool isUnknown() const
+    {
+        return state == State::Unknown;
+    }
+
+    bool containsZero() const
+    {
+        return lo <= 0 && hi >= 0;
+    }
+
+    bool fitsI32() const
+    {
+        return isKnown() && lo >= INT32_MIN && hi <= INT32_MAX;
+    }
+
+    bool operator==(const IntRange &other) const
+    {
+        return state == other.state && (state != State::Known || (lo == other.lo && hi == other.hi));
+    }
+
+    bool operator!=(const IntRange &other) const
+    {
+        return !(*this == other);
+    }
+
+    IntRange join(const IntRange &other) const
+    {
+        if (isBottom() || other.isUnknown())
+        {
+            return other;
+        }
+
+        if (other.isBottom() || isUnknown())
+        {
+            return *this;
+        }
+
+        return of(std::min(lo, other.lo), std::max(hi, other.hi));
+    }
+};
+
+// Integer range analysis: 'number' is a double, so loop counters, indices, bit operations and '%' are done in floating
+// point and converted back with fptosi when used as array index. The pass proves that values are integers in safe
+// range (literals, casts from integers, length, |0, +, -, *, %, ++, --) and moves them to i32/i64:
+//  - local variables of type 'number' which are only loaded and stored get integer type (their stores are computed in
+//    integers)
+//  - casts of proven values to integers (array indices, bitwise ops) and comparisons of proven values use integers
+// Values keep 'number' representation (sitofp) where they escape: calls, returns, fields, division etc.
+// Values are never narrowed if they may be -0, NaN or Infinity.
+class IntegerRangePass : public mlir::PassWrapper<IntegerRangePass, ModulePass>
+{
+    // candidate variable -> stores (VariableOp with initializer, StoreOp, PrefixUnaryOp, PostfixUnaryOp)
+    llvm::MapVector<mlir::Operation *, llvm::SmallVector<mlir::Operation *>> variableStores;
+    llvm::DenseMap<mlir::Operation *, IntRange> variableRanges;
+    llvm::DenseMap<mlir::Operation *, bool> widenedVariables;
+    llvm::DenseMap<mlir::Value, IntRange> valueRanges;
+
+    // rewrite state
+    llvm::DenseMap<mlir::Operation *, mlir_ts::VariableOp> newVariables;
+    llvm::DenseMap<std::pair<mlir::Value, mlir::Type>, mlir::Value> materialized;
+    llvm::DenseMap<mlir::Operation *, mlir::Value> newLoads;
+    llvm::DenseMap<mlir::Operation *, mlir::Value> newUnaryOps;
+
+  public:
+    MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(IntegerRangePass)
+
+    void runOnModule() override
+    {
+        auto m = getModule();
+
+        m.walk([&](mlir_ts::FuncOp funcOp) {
+            if (!funcOp.isExternal())
+            {
+                narrowFunction(funcOp);
+            }
+        });
+
+        LLVM_DEBUG(llvm::dbgs() << "\n!! AFTER INTEGER RANGE DUMP: \n" << m << "\n";);
+    }
+
+  private:
+    void narrowFunction(mlir_ts::FuncOp funcOp)
+    {
+        variableStores.clear();
+        variableRanges.clear();
+        widenedVariables.clear();
+        valueRanges.clear();
+        newVariables.clear();
+        materialized.clear();
+        newLoads.clear();
+        newUnaryOps.clear();
+
+        collectVariables(funcOp);
+        computeVariableRanges();
+
+        // proven values used as integers or compared
+        llvm::SmallVector<mlir_ts::CastOp> castOps;
+        llvm::SmallVector<mlir_ts::LogicalBinaryOp> compareOps;
+        funcOp.walk([&](mlir::Operation *op) {
+            if (op->getParentOfType<mlir_ts::FuncOp>() != funcOp)
+            {
+                return;
+            }
+
+            if (auto castOp = dyn_cast<mlir_ts::CastOp>(op))
+            {
+                auto resType = castOp.getType();
+                if (castOp.getIn().getType().isa<mlir_ts::NumberType>() && resType.isSignlessInteger() &&
+                    (resType.isInteger(32) || resType.isInteger(64)) && evaluate(castOp.getIn()).isKnown())
+                {
+                    castOps.push_back(castOp);
+                }
+            }
+            else if (auto logicalBinaryOp = dyn_cast<mlir_ts::LogicalBinaryOp>(op))
+            {
+                if (isComparison((SyntaxKind)logicalBinaryOp.getOpCode()) &&
+                    logicalBinaryOp.getOperand1().getType().isa<mlir_ts::NumberType>() &&
+                    logicalBinaryOp.getOperand2().getType().isa<mlir_ts::NumberType>() &&
+                    evaluate(logicalBinaryOp.getOperand1()).isKnown() &&
+                    evaluate(logicalBinaryOp.getOperand2()).isKnown())
+                {
+                    compareOps.push_back(logicalBinaryOp);
+                }
+            }
+        });
+
+        llvm::SmallVector<mlir::Operation *> narrowed;
+        for (auto &variableStore : variableStores)
+        {
+            if (variableRanges[variableStore.first].isKnown())
+            {
+                narrowed.push_back(variableStore.first);
+            }
+        }
+
+        if (narrowed.empty() && castOps.empty() && compareOps.empty())
+        {
+            return;
+        }
+
+        // all integer values are created first, while analysis still sees original IR
+        llvm::SmallVector<std::pair<mlir::Value, mlir::Value>> replacements;
+        llvm::SmallVector<mlir::Operation *> erased;
+
+        // variables are in order of declaration, so initializers can use loads of already narrowed variables
+        for (auto *variable : narrowed)
+        {
+            createNewVariable(cast<mlir_ts::VariableOp>(variable));
+        }
+
+        for (auto *variable : narrowed)
+        {
+            auto newVariable = newVariables[variable];
+            auto intType = newVariable.getType().cast<mlir_ts::RefType>().getElementType();
+            for (auto *storeOp : variableStores[variable])
+            {
+                if (auto oldStoreOp = dyn_cast<mlir_ts::StoreOp>(storeOp))
+                {
+                    auto value = materialize(oldStoreOp.getValue(), intType);
+                    mlir::OpBuilder builder(oldStoreOp);
+                    builder.create<mlir_ts::StoreOp>(oldStoreOp->getLoc(), value, newVariable.getReference());
+                    erased.push_back(oldStoreOp);
+                }
+                else if (isa<mlir_ts::PrefixUnaryOp>(storeOp) || isa<mlir_ts::PostfixUnaryOp>(storeOp))
+                {
+                    // increment is stored into new variable by lowering
+                    replacements.push_back({storeOp->getResult(0), getNewUnaryOp(storeOp)});
+                    erased.push_back(storeOp);
+                }
+            }
+
+            for (auto *user : variable->getUsers())
+            {
+                if (auto loadOp = dyn_cast<mlir_ts::LoadOp>(user))
+                {
+                    if (!loadOp.getResult().use_empty())
+                    {
+                        replacements.push_back({loadOp.getResult(), getNewLoad(loadOp)});
+                    }
+
+                    erased.push_back(loadOp);
+                }
+            }
+        }
+
+        for (auto castOp : castOps)
+        {
+            auto range = evaluate(castOp.getIn());
+            auto value = materialize(castOp.getIn(), getIntType(range, castOp.getContext()));
+            mlir::OpBuilder builder(castOp);
+            replacements.push_back({castOp.getRes(), convertInteger(builder, value, range, castOp.getType())});
+            erased.push_back(castOp);
+        }
+
+        for (auto compareOp : compareOps)
+        {
+            auto range1 = evaluate(compareOp.getOperand1());
+            auto range2 = evaluate(compareOp.getOperand2());
+            auto intType = getIntType(range1.join(range2), compareOp.getContext());
+            auto value1 = materialize(compareOp.getOperand1(), intType);
+            auto value2 = materialize(compareOp.getOperand2(), intType);
+            mlir::OpBuilder builder(compareOp);
+            auto newCompareOp = builder.create<mlir_ts::LogicalBinaryOp>(
+                compareOp->getLoc(), compareOp.getType(), compareOp.getOpCodeAttr(), value1, value2);
+            replacements.push_back({compareOp.getResult(), newCompareOp.getResult()});
+            erased.push_back(compareOp);
+        }
+
+        // values which are left in use get 'number' back (escapes)
+        for (auto &replacement : replacements)
+        {
+            auto oldValue = replacement.first;
+            auto newValue = replacement.second;
+            if (oldValue.use_empty())
+            {
+                continue;
+            }
+
+            if (oldValue.getType() != newValue.getType())
+            {
+                mlir::OpBuilder builder(newValue.getContext());
+                builder.setInsertionPointAfterValue(newValue);
+                newValue = builder.create<mlir_ts::CastOp>(oldValue.getLoc(), oldValue.getType(), newValue);
+            }
+
+            oldValue.replaceAllUsesWith(newValue);
+        }
+
+        erased.append(narrowed.begin(), narrowed.end());
+
+        // uses first
+        for (auto *op : erased)
+        {
+            op->dropAllUses();
+        }
+
+        llvm::SmallPtrSet<mlir::Operation *, 16> erasedOps(erased.begin(), erased.end());
+        llvm::SmallVector<mlir::Operation *> operandOps;
+        for (auto *op : erased)
+        {
+            for (auto operand : op->getOperands())
+            {
+                if (auto *defOp = operand.getDefiningOp())
+                {
+                    if (!erasedOps.count(defOp))
+                    {
+                        operandOps.push_back(defOp);
+                    }
+                }
+            }
+        }
+
+        for (auto *op : erased)
+        {
+            op->dropAllReferences();
+        }
+
+        for (auto *op : erased)
+        {
+            op->erase();
+        }
+
+        eraseDeadOps(operandOps);
+    }
+
+    bool isComparison(SyntaxKind opCode)
+    {
+        switch (opCode)
+        {
+        case SyntaxKind::EqualsEqualsToken:
+        case SyntaxKind::EqualsEqualsEqualsToken:
+        case SyntaxKind::ExclamationEqualsToken:
+        case SyntaxKind::ExclamationEqualsEqualsToken:
+        case SyntaxKind::GreaterThanToken:
+        case SyntaxKind::GreaterThanEqualsToken:
+        case SyntaxKind::LessThanToken:
+        case SyntaxKind::LessThanEqualsToken:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // variables of type 'number' which are used only for loads, stores and increments
+    void collectVariables(mlir_ts::FuncOp funcOp)
+    {
+        funcOp.walk([&](mlir_ts::VariableOp variableOp) {
+            if (variableOp->getParentOfType<mlir_ts::FuncOp>() != funcOp)
+            {
+                return;
+            }
+
+            auto refType = variableOp.getType().dyn_cast<mlir_ts::RefType>();
+            if (!refType || !refType.getElementType().isa<mlir_ts::NumberType>())
+            {
+                return;
+            }
+
+            if (variableOp.getCaptured().has_value() && variableOp.getCaptured().value())
+            {
+                return;
+            }
+
+            llvm::SmallVector<mlir::Operation *> stores;
+            if (variableOp.getInitializer())
+            {
+                stores.push_back(variableOp);
+            }
+
+            for (auto *user : variableOp->getUsers())
+            {
+                if (auto storeOp = dyn_cast<mlir_ts::StoreOp>(user))
+                {
+                    if (storeOp.getReference() == variableOp.getReference() &&
+                        storeOp.getValue() != variableOp.getReference())
+                    {
+                        stores.push_back(storeOp);
+                        continue;
+                    }
+
+                    return;
+                }
+
+                auto loadOp = dyn_cast<mlir_ts::LoadOp>(user);
+                if (!loadOp)
+                {
+                    return;
+                }
+
+                // ++ and -- store result into reference of the load
+                for (auto *loadUser : loadOp->getUsers())
+                {
+                    if (isa<mlir_ts::PrefixUnaryOp>(loadUser) || isa<mlir_ts::PostfixUnaryOp>(loadUser))
+                    {
+                        stores.push_back(loadUser);
+                    }
+                }
+            }
+
+            if (stores.empty())
+            {
+                return;
+            }
+
+            variableStores[variableOp] = stores;
+            variableRanges[variableOp] = IntRange::bottom();
+        });
+    }
+
+    void computeVariableRanges()
+    {
+        auto changed = true;
+        for (auto iteration = 0; changed; iteration++)
+        {
+            changed = false;
+            valueRanges.clear();
+            for (auto &variableStore : variableStores)
+            {
+                auto *variable = variableStore.first;
+                auto range = IntRange::bottom();
+                for (auto *storeOp : variableStore.second)
+                {
+                    range = range.join(evaluateStore(variable, storeOp));
+                }
+
+                auto current = variableRanges[variable];
+                range = current.join(range);
+                if (range == current)
+                {
+                    continue;
+                }
+
+                if (iteration >= MaxIterationsBeforeWidening)
+                {
+                    range = widen(variable, range);
+                }
+
+                LLVM_DEBUG(llvm::dbgs() << "\n!! range of: " << *variable << " -> "
+                                        << (range.isKnown() ? "known" : "unknown") << " [" << range.lo << ", "
+                                        << range.hi << "]\n";);
+
+                variableRanges[variable] = range;
+                changed = true;
+            }
+        }
+
+        // ranges of values for rewrite
+        valueRanges.clear();
+    }
+
+    IntRange widen(mlir::Operation *variable, IntRange range)
+    {
+#ifdef NUMBER_F64
+        if (range.isKnown() && !widenedVariables[variable] &&
+            llvm::any_of(variableStores[variable],
+                         [&](mlir::Operation *storeOp) { return isInductionStep(variable, storeOp); }))
+        {
+            widenedVariables[variable] = true;
+            return IntRange::of(-MaxSafeInteger + MaxInductionStep, MaxSafeInteger - MaxInductionStep);
+        }
+#endif
+
+        return IntRange::unknown();
+    }
+
+    bool isLoadOf(mlir::Value value, mlir::Operation *variable)
+    {
+        auto loadOp = value.getDefiningOp<mlir_ts::LoadOp>();
+        return loadOp && loadOp.getReference().getDefiningOp() == variable;
+    }
+
+    // v++, v--, v = v + c, v = v - c, v = c + v
+    bool isInductionStep(mlir::Operation *variable, mlir::Operation *storeOp)
+    {
+        if (isa<mlir_ts::PrefixUnaryOp>(storeOp) || isa<mlir_ts::PostfixUnaryOp>(storeOp))
+        {
+            return true;
+        }
+
+        auto store = dyn_cast<mlir_ts::StoreOp>(storeOp);
+        if (!store)
+        {
+            return false;
+        }
+
+        auto binOp = store.getValue().getDefiningOp<mlir_ts::ArithmeticBinaryOp>();
+        if (!binOp)
+        {
+            return false;
+        }
+
+        auto opCode = (SyntaxKind)binOp.getOpCode();
+        mlir::Value step;
+        if (isLoadOf(binOp.getOperand1(), variable) &&
+            (opCode == SyntaxKind::PlusToken || opCode == SyntaxKind::MinusToken))
+        {
+            step = binOp.getOperand2();
+        }
+        else if (isLoadOf(binOp.getOperand2(), variable) && opCode == SyntaxKind::PlusToken)
+        {
+            step = binOp.getOperand1();
+        }
+        else
+        {
+            return false;
+        }
+
+        auto stepRange = evaluate(step);
+        return stepRange.isKnown() && stepRange.lo == stepRange.hi && std::abs(stepRange.lo) <= MaxInductionStep;
+    }
+
+    IntRange evaluateStore(mlir::Operation *variable, mlir::Operation *storeOp)
+    {
+        // widened variable: induction steps keep value in its own range
+        if (widenedVariables[variable] && isInductionStep(variable, storeOp))
+        {
+            return variableRanges[variable];
+        }
+
+        if (auto variableOp = dyn_cast<mlir_ts::VariableOp>(storeOp))
+        {
+            return evaluate(variableOp.getInitializer());
+        }
+
+        if (auto store = dyn_cast<mlir_ts::StoreOp>(storeOp))
+        {
+            return evaluate(store.getValue());
+        }
+
+        if (auto prefixOp = dyn_cast<mlir_ts::PrefixUnaryOp>(storeOp))
+        {
+            return evaluate(prefixOp.getResult());
+        }
+
+        if (auto postfixOp = dyn_cast<mlir_ts::PostfixUnaryOp>(storeOp))
+        {
+            return step(evaluate(postfixOp.getOperand1()), (SyntaxKind)postfixOp.getOpCode());
+        }
+
+        return IntRange::unknown();
+    }
+
+    IntRange step(IntRange range, SyntaxKind opCode)
+    {
+        if (!range.isKnown())
+        {
+            return range;
+        }
+
+        auto delta = opCode == SyntaxKind::PlusPlusToken ? 1 : -1;
+        return IntRange::of(range.lo + delta, range.hi + delta);
+    }
+
+    IntRange evaluateInteger(mlir::Value value)
+    {
+        if (auto constantOp = value.getDefiningOp<mlir_ts::ConstantOp>())
+        {
+            if (auto intAttr = constantOp.getValueAttr().dyn_cast_or_null<mlir::IntegerAttr>())
+            {
+                if (intAttr.getType().isUnsignedInteger())
+                {
+                    auto intValue = intAttr.getValue();
+                    return intValue.getActiveBits() < 63
+                               ? IntRange::of(intValue.getZExtValue(), intValue.getZExtValue())
+                               : IntRange::unknown();
+                }
+
+                auto intValue = intAttr.getValue();
+                return intValue.getSignificantBits() <= 64
+                           ? IntRange::of(intValue.getSExtValue(), intValue.getSExtValue())
+                           : IntRange::unknown();
+            }
+        }
+
+        if (value.getDefiningOp<mlir_ts::LengthOfOp>())
+        {
+            return IntRange::of(0, INT32_MAX);
+        }
+
+        auto type = value.getType();
+        if (auto literalType = type.dyn_cast<mlir_ts::LiteralType>())
+        {
+            type = literalType.getElementType();
+        }
+
+        auto intType = type.dyn_cast<mlir::IntegerType>();
+        if (!intType || intType.getWidth() <= 1 || intType.getWidth() > 32)
+        {
+            return IntRange::unknown();
+        }
+
+        auto width = intType.getWidth();
+        if (intType.isUnsigned())
+        {
+            return IntRange::of(0, (int64_t(1) << width) - 1);
+        }
+
+        return IntRange::of(-(int64_t(1) << (width - 1)), (int64_t(1) << (width - 1)) - 1);
+    }
+
+    IntRange evaluateConstant(mlir::Attribute attr)
+    {
+        if (auto floatAttr = attr.dyn_cast_or_null<mlir::FloatAttr>())
+        {
+            auto value = floatAttr.getValue();
+            if (!value.isFinite() || value.isNegZero() || !value.isInteger())
+            {
+                return IntRange::unknown();
+            }
+
+            auto doubleValue = floatAttr.getValueAsDouble();
+            if (std::fabs(doubleValue) > (double)MaxSafeInteger)
+            {
+                return IntRange::unknown();
+            }
+
+            return IntRange::of((int64_t)doubleValue, (int64_t)doubleValue);
+        }
+
+        return IntRange::unknown();
+    }
+
+    IntRange evaluate(mlir::Value value)
+    {
+        auto it = valueRanges.find(value);
+        if (it != valueRanges.end())
+        {
+            return it->second;
+        }
+
+        auto range = evaluateValue(value);
+        valueRanges[value] = range;
+        return range;
+    }
+
+    IntRange evaluateValue(mlir::Value value)
+    {
+        if (!value.getType().isa<mlir_ts::NumberType>())
+        {
+            return IntRange::unknown();
+        }
+
+        auto *defOp = value.getDefiningOp();
+        if (!defOp)
+        {
+            return IntRange::unknown();
+        }
+
+        if (auto constantOp = dyn_cast<mlir_ts::ConstantOp>(defOp))
+        {
+            if (constantOp.getValueAttr().isa<mlir::IntegerAttr>())
+            {
+                return evaluateInteger(value);
+            }
+
+            return evaluateConstant(constantOp.getValueAttr());
+        }
+
+        if (auto castOp = dyn_cast<mlir_ts::CastOp>(defOp))
+        {
+            return evaluateInteger(castOp.getIn());
+        }
+
+        if (auto loadOp = dyn_cast<mlir_ts::LoadOp>(defOp))
+        {
+            auto it = variableRanges.find(loadOp.getReference().getDefiningOp());
+            return it != variableRanges.end() ? it->second : IntRange::unknown();
+        }
+
+        if (auto prefixOp = dyn_cast<mlir_ts::PrefixUnaryOp>(defOp))
+        {
+            return step(evaluate(prefixOp.getOperand1()), (SyntaxKind)prefixOp.getOpCode());
+        }
+
+        if (auto postfixOp = dyn_cast<mlir_ts::PostfixUnaryOp>(defOp))
+        {
+            return evaluate(postfixOp.getOperand1());
+        }
+
+        if (auto unaryOp = dyn_cast<mlir_ts::ArithmeticUnaryOp>(defOp))
+        {
+            auto range = evaluate(unaryOp.getOperand1());
+            if (!range.isKnown())
+            {
+                return range;
+            }
+
+            switch ((SyntaxKind)unaryOp.getOpCode())
+            {
+            case SyntaxKind::PlusToken:
+                return range;
+            case SyntaxKind::MinusToken:
+                // -0
+                return range.containsZero() ? IntRange::unknown() : IntRange::of(-range.hi, -range.lo);
+            default:
+                return IntRange::unknown();
+            }
+        }
+
+        if (auto binOp = dyn_cast<mlir_ts::ArithmeticBinaryOp>(defOp))
+        {
+            auto left = evaluate(binOp.getOperand1());
+            auto right = evaluate(binOp.getOperand2());
+            if (left.isUnknown() || right.isUnknown())
+            {
+                return IntRange::unknown();
+            }
+
+            if (left.isBottom() || right.isBottom())
+            {
+                return IntRange::bottom();
+            }
+
+            switch ((SyntaxKind)binOp.getOpCode())
+            {
+            case SyntaxKind::PlusToken:
+                return IntRange::of(left.lo + right.lo, left.hi + right.hi);
+            case SyntaxKind::MinusToken:
+                return IntRange::of(left.lo - right.hi, left.hi - right.lo);
+            case SyntaxKind::AsteriskToken:
+                return multiply(left, right);
+            case SyntaxKind::PercentToken:
+                // negative dividend can give -0, zero divisor gives NaN
+                if (left.lo < 0 || right.containsZero())
+                {
+                    return IntRange::unknown();
+                }
+
+                return IntRange::of(0, std::min(left.hi, std::max(std::abs(right.lo), std::abs(right.hi)) - 1));
+            default:
+                return IntRange::unknown();
+            }
+        }
+
+        return IntRange::unknown();
+    }
+
+    IntRange multiply(IntRange left, IntRange right)
+    {
+        // 0 * negative is -0
+        if ((left.lo < 0 && right.containsZero()) || (right.lo < 0 && left.containsZero()))
+        {
+            return IntRange::unknown();
+        }
+
+        int64_t bounds[] = {0, 0, 0, 0};
+        int64_t leftBounds[] = {left.lo, left.hi};
+        int64_t rightBounds[] = {right.lo, right.hi};
+        auto index = 0;
+        for (auto l : leftBounds)
+        {
+            for (auto r : rightBounds)
+            {
+                // operands are in safe range, so the product fits int64 if it is close to safe range
+                if (std::fabs((double)l * (double)r) > 2.0 * (double)MaxSafeInteger)
+                {
+                    return IntRange::unknown();
+                }
+
+                bounds[index++] = l * r;
+            }
+        }
+
+        return IntRange::of(*std::min_element(bounds, bounds + 4), *std::max_element(bounds, bounds + 4));
+    }
+
+    mlir::Type getIntType(IntRange range, mlir::MLIRContext *context)
+    {
+        return mlir::IntegerType::get(context, range.fitsI32() ? 32 : 64);
+    }
+
+    // integer casts are zero extended (see CastOp::fold), negative values are sign extended via 'number'
+    // (LLVM folds sitofp + fptosi into sext)
+    mlir::Value convertInteger(mlir::OpBuilder &builder, mlir::Value value, IntRange range, mlir::Type intType)
+    {
+        if (value.getType() == intType)
+        {
+            return value;
+        }
+
+        auto loc = value.getLoc();
+        auto fromWidth = value.getType().getIntOrFloatBitWidth();
+        if (fromWidth > intType.getIntOrFloatBitWidth() || range.lo >= 0)
+        {
+            return builder.create<mlir_ts::CastOp>(loc, intType, value);
+        }
+
+        auto numberValue =
+            builder.create<mlir_ts::CastOp>(loc, mlir_ts::NumberType::get(builder.getContext()), value);
+        return builder.create<mlir_ts::CastOp>(loc, intType, numberValue);
+    }
+
+    void createNewVariable(mlir_ts::VariableOp variableOp)
+    {
+        auto range = variableRanges[variableOp];
+        auto intType = getIntType(range, variableOp.getContext());
+
+        mlir::Value init;
+        if (variableOp.getInitializer())
+        {
+            init = materialize(variableOp.getInitializer(), intType);
+        }
+
+        mlir::OpBuilder builder(variableOp);
+        auto newVariable = builder.create<mlir_ts::VariableOp>(
+            variableOp->getLoc(), mlir_ts::RefType::get(intType), init, variableOp.getCapturedAttr());
+        newVariables[variableOp] = newVariable;
+    }
+
+    mlir::Value getNewLoad(mlir_ts::LoadOp loadOp)
+    {
+        auto it = newLoads.find(loadOp);
+        if (it != newLoads.end())
+        {
+            return it->second;
+        }
+
+        auto newVariable = newVariables[loadOp.getReference().getDefiningOp()];
+        mlir::OpBuilder builder(loadOp->getContext());
+        builder.setInsertionPointAfter(loadOp);
+        auto newLoad = builder.create<mlir_ts::LoadOp>(
+            loadOp->getLoc(), newVariable.getType().cast<mlir_ts::RefType>().getElementType(),
+            newVariable.getReference());
+        newLoads[loadOp] = newLoad.getResult();
+        return newLoad.getResult();
+    }
+
+    mlir::Value getNewUnaryOp(mlir::Operation *op)
+    {
+        auto it = newUnaryOps.find(op);
+        if (it != newUnaryOps.end())
+        {
+            return it->second;
+        }
+
+        auto loadOp = op->getOperand(0).getDefiningOp<mlir_ts::LoadOp>();
+        auto newLoad = getNewLoad(loadOp);
+        mlir::OpBuilder builder(op->getContext());
+        builder.setInsertionPointAfter(op);
+
+        mlir::Value newValue;
+        if (auto prefixOp = dyn_cast<mlir_ts::PrefixUnaryOp>(op))
+        {
+            newValue = builder.create<mlir_ts::PrefixUnaryOp>(op->getLoc(), newLoad.getType(),
+                                                              prefixOp.getOpCodeAttr(), newLoad);
+        }
+        else
+        {
+            auto postfixOp = cast<mlir_ts::PostfixUnaryOp>(op);
+            newValue = builder.create<mlir_ts::PostfixUnaryOp>(op->getLoc(), newLoad.getType(),
+                                                               postfixOp.getOpCodeAttr(), newLoad);
+        }
+
+        newUnaryOps[op] = newValue;
+        return newValue;
+    }
+
+    // integer value of proven 'number' value, created next to its definition
+    mlir::Value materialize(mlir::Value value, mlir::Type intType)
+    {
+        auto key = std::make_pair(value, intType);
+        auto it = materialized.find(key);
+        if (it != materialized.end())
+        {
+            return it->second;
+        }
+
+        auto result = materializeValue(value, intType);
+        materialized[key] = result;
+        return result;
+    }
+
+    mlir::Value materializeValue(mlir::Value value, mlir::Type intType)
+    {
+        auto range = evaluate(value);
+        assert(range.isKnown());
+
+        auto *defOp = value.getDefiningOp();
+        auto loc = value.getLoc();
+        mlir::OpBuilder builder(value.getContext());
+        builder.setInsertionPointAfter(defOp);
+
+        if (isa<mlir_ts::ConstantOp>(defOp))
+        {
+            return builder.create<mlir_ts::ConstantOp>(loc, intType, builder.getIntegerAttr(intType, range.lo));
+        }
+
+        if (auto castOp = dyn_cast<mlir_ts::CastOp>(defOp))
+        {
+            auto in = castOp.getIn();
+            if (auto literalType = in.getType().dyn_cast<mlir_ts::LiteralType>())
+            {
+                return builder.create<mlir_ts::ConstantOp>(loc, intType, builder.getIntegerAttr(intType, range.lo));
+            }
+
+            auto inType = in.getType().dyn_cast<mlir::IntegerType>();
+            if (inType && inType.isSignless())
+            {
+                return convertInteger(builder, in, evaluateInteger(in), intType);
+            }
+        }
+
+        if (auto loadOp = dyn_cast<mlir_ts::LoadOp>(defOp))
+        {
+            if (newVariables.count(loadOp.getReference().getDefiningOp()))
+            {
+                auto newLoad = getNewLoad(loadOp);
+                builder.setInsertionPointAfterValue(newLoad);
+                return convertInteger(builder, newLoad, range, intType);
+            }
+        }
+
+        if (isa<mlir_ts::PrefixUnaryOp>(defOp) || isa<mlir_ts::PostfixUnaryOp>(defOp))
+        {
+            auto loadOp = defOp->getOperand(0).getDefiningOp<mlir_ts::LoadOp>();
+            if (loadOp && newVariables.count(loadOp.getReference().getDefiningOp()))
+            {
+                auto newValue = getNewUnaryOp(defOp);
+                builder.setInsertionPointAfterValue(newValue);
+                return convertInteger(builder, newValue, range, intType);
+            }
+        }
+
+        if (auto unaryOp = dyn_cast<mlir_ts::ArithmeticUnaryOp>(defOp))
+        {
+            auto opType = getIntType(range.join(evaluate(unaryOp.getOperand1())), value.getContext());
+            auto operand = materialize(unaryOp.getOperand1(), opType);
+            builder.setInsertionPointAfter(defOp);
+            auto newValue =
+                builder.create<mlir_ts::ArithmeticUnaryOp>(loc, opType, unaryOp.getOpCodeAttr(), operand);
+            return convertInteger(builder, newValue, range, intType);
+        }
+
+        if (auto binOp = dyn_cast<mlir_ts::ArithmeticBinaryOp>(defOp))
+        {
+            // operands and result must fit the type of operation
+            auto opType = getIntType(
+                range.join(evaluate(binOp.getOperand1())).join(evaluate(binOp.getOperand2())), value.getContext());
+            auto operand1 = materialize(binOp.getOperand1(), opType);
+            auto operand2 = materialize(binOp.getOperand2(), opType);
+            builder.setInsertionPointAfter(defOp);
+            auto newValue = builder.create<mlir_ts::ArithmeticBinaryOp>(loc, opType, binOp.getOpCodeAttr(),
+                                                                        operand1, operand2);
+            return convertInteger(builder, newValue, range, intType);
+        }
+
+        // value is integer in range, conversion is exact
+        return builder.create<mlir_ts::CastOp>(loc, intType, value);
+    }
+
+    void eraseDeadOps(llvm::SmallVector<mlir::Operation *> &worklist)
+    {
+        llvm::SmallPtrSet<mlir::Operation *, 16> erasedOps;
+        while (!worklist.empty())
+        {
+            auto *op = worklist.pop_back_val();
+            if (erasedOps.count(op) || !mlir::isOpTriviallyDead(op))
+            {
+                continue;
+            }
+
+            for (auto operand : op->getOperands())
+            {
+                if (auto *defOp = operand.getDefiningOp())
+                {
+                    worklist.push_back(defOp);
+                }
+            }
+
+            erasedOps.insert(op);
+            op->erase();
+        }
+    }
+};
+
+} // end anonymous namespace
+
+std::unique_ptr<mlir::Pass> mlir_ts::createIntegerRangePass()
+{
+    return std::make_unique<IntegerRangePass>();
+}
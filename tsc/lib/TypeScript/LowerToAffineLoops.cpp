@@ -2,6 +2,7 @@
 
 #include "TypeScript/Config.h"
 #include "TypeScript/DataStructs.h"
+#include "TypeScript/MemoryStats.h"
 #include "TypeScript/Passes.h"
 #include "TypeScript/TypeScriptDialect.h"
 #include "TypeScript/TypeScriptFunctionPass.h"
@@ -18,8 +19,10 @@
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/Dialect/Async/IR/Async.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/DialectConversion.h"
+#include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/Sequence.h"
 #include "mlir/IR/Dialect.h"
@@ -1509,9 +1512,9 @@ struct CaptureOpLowering : public TsPattern<mlir_ts::CaptureOp>
 
         LLVM_DEBUG(llvm::dbgs() << "\n!! ...capture store type: " << captureStoreType << "\n\n";);
 
-        // true => we need to allocate capture in heap memory
+        // true => we need to allocate capture in heap memory, closure which does not escape keeps capture in stack
 #ifdef ALLOC_CAPTURE_IN_HEAP
-        auto inHeapMemory = true;
+        auto inHeapMemory = !captureOp.getStackAlloc().has_value() || !captureOp.getStackAlloc().value();
 #else
         auto inHeapMemory = false;
 #endif
@@ -1725,6 +1728,123 @@ void cleanupEmptyBlocksWithoutPredecessors(mlir_ts::FuncOp f)
     } while (any);
 }
 
+// array variable is not changed in loop: it is not captured, it is only loaded inside of loop and outside it is only
+// loaded, stored or modified by push/pop
+bool isArrayVariableInvariantInLoop(mlir_ts::VariableOp variableOp, mlir::Operation *loopOp)
+{
+    if (variableOp.getCaptured().has_value() && variableOp.getCaptured().value())
+    {
+        return false;
+    }
+
+    auto reference = variableOp.getReference();
+    for (auto &use : reference.getUses())
+    {
+        auto *user = use.getOwner();
+        if (isa<mlir_ts::LoadOp>(user))
+        {
+            continue;
+        }
+
+        if (loopOp->isAncestor(user))
+        {
+            return false;
+        }
+
+        if (auto storeOp = dyn_cast<mlir_ts::StoreOp>(user))
+        {
+            if (storeOp.getReference() == reference && storeOp.getValue() != reference)
+            {
+                continue;
+            }
+        }
+
+        if (isa<mlir_ts::PushOp, mlir_ts::PopOp>(user) && use.getOperandNumber() == 0)
+        {
+            continue;
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+bool isInAsyncBody(mlir::Operation *op, mlir::Operation *loopOp)
+{
+    for (auto *parentOp = op->getParentOp(); parentOp && parentOp != loopOp; parentOp = parentOp->getParentOp())
+    {
+        if (isa<mlir::async::ExecuteOp>(parentOp))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// counted loops (for-of over arrays, index loops) reload array struct {data, length} from variable on each iteration,
+// array variables are registered as GC roots so LLVM can't promote them into registers. Array which is not changed in
+// loop is loaded once before loop, and pure operations of condition which depend on values defined outside of loop
+// (length of array etc.) are hoisted as well, so data pointer and trip count are loop invariant for LLVM loop
+// optimizations (induction variable of counted loop is i32 already as integer literals are typed as i32)
+void hoistLoopInvariantArrayLoads(mlir_ts::FuncOp f)
+{
+    // post order, inner loops first, so loads hoisted from inner loop can be hoisted from outer one as well
+    f.walk([&](mlir_ts::ForOp forOp) {
+        llvm::MapVector<mlir::Operation *, SmallVector<mlir_ts::LoadOp>> loadsByVariable;
+        forOp.walk([&](mlir_ts::LoadOp loadOp) {
+            if (!loadOp.getType().isa<mlir_ts::ArrayType>() || isInAsyncBody(loadOp, forOp))
+            {
+                return;
+            }
+
+            auto variableOp = loadOp.getReference().getDefiningOp<mlir_ts::VariableOp>();
+            if (variableOp && !forOp->isAncestor(variableOp))
+            {
+                loadsByVariable[variableOp].push_back(loadOp);
+            }
+        });
+
+        for (auto &loadsOfVariable : loadsByVariable)
+        {
+            auto variableOp = cast<mlir_ts::VariableOp>(loadsOfVariable.first);
+            if (!isArrayVariableInvariantInLoop(variableOp, forOp))
+            {
+                continue;
+            }
+
+            auto &loads = loadsOfVariable.second;
+
+            mlir::OpBuilder builder(forOp);
+            auto hoistedLoad = builder.create<mlir_ts::LoadOp>(loads.front().getLoc(), loads.front().getType(),
+                                                               variableOp.getReference());
+            for (auto loadOp : loads)
+            {
+                loadOp.replaceAllUsesWith(hoistedLoad.getResult());
+                loadOp.erase();
+            }
+        }
+
+        auto isDefinedOutside = [&](mlir::Value value) {
+            return !forOp->isAncestor(value.getParentRegion()->getParentOp());
+        };
+
+        for (auto &op : llvm::make_early_inc_range(forOp.getCond().front()))
+        {
+            if (op.hasTrait<OpTrait::IsTerminator>() || op.getNumRegions() > 0 || !mlir::isPure(&op))
+            {
+                continue;
+            }
+
+            if (llvm::all_of(op.getOperands(), isDefinedOutside))
+            {
+                op.moveBefore(forOp);
+            }
+        }
+    });
+}
+
 void AddTsAffineLegalOps(ConversionTarget &target)
 {
     // We define the specific operations, or dialects, that are legal targets for
@@ -1745,7 +1865,8 @@ void AddTsAffineLegalOps(ConversionTarget &target)
         mlir_ts::PointerOffsetRefOp, mlir_ts::FuncOp, mlir_ts::GlobalOp, mlir_ts::GlobalResultOp, mlir_ts::HasValueOp,
         mlir_ts::ValueOp, mlir_ts::ValueOrDefaultOp, mlir_ts::NullOp, mlir_ts::ParseFloatOp, mlir_ts::ParseIntOp, mlir_ts::IsNaNOp,
         mlir_ts::PrintOp, mlir_ts::SizeOfOp, mlir_ts::StoreOp, mlir_ts::SymbolRefOp, mlir_ts::LengthOfOp,
-        mlir_ts::StringLengthOp, mlir_ts::StringConcatOp, mlir_ts::StringCompareOp, mlir_ts::LoadOp, mlir_ts::NewOp,
+        mlir_ts::StringLengthOp, mlir_ts::StringConcatOp, mlir_ts::StringCompareOp, mlir_ts::StringBuilderOp,
+        mlir_ts::StringAppendOp, mlir_ts::LoadOp, mlir_ts::NewOp,
         mlir_ts::CreateTupleOp, mlir_ts::DeconstructTupleOp, mlir_ts::CreateArrayOp, mlir_ts::NewEmptyArrayOp,
         mlir_ts::NewArrayOp, mlir_ts::DeleteOp, mlir_ts::PropertyRefOp, mlir_ts::InsertPropertyOp,
         mlir_ts::ExtractPropertyOp, mlir_ts::LogicalBinaryOp, mlir_ts::UndefOp, mlir_ts::VariableOp, mlir_ts::AllocaOp,
@@ -1803,6 +1924,8 @@ void TypeScriptToAffineLoweringTSFuncPass::runOnFunction()
         }
     }
 
+    hoistLoopInvariantArrayLoads(function);
+
     // The first thing to define is the conversion target. This will define the
     // final target for this lowering.
     ConversionTarget target(getContext());
@@ -1883,6 +2006,8 @@ void TypeScriptToAffineLoweringModulePass::runOnOperation()
     {
         signalPassFailure();
     }    
+
+    MemoryStats::recordOpCount("after affine lowering", module);
 }
 
 /// Create a pass for lowering operations in the `Affine` and `Std` dialects,
@@ -2,6 +2,7 @@
 
 #include "TypeScript/Config.h"
 #include "TypeScript/DataStructs.h"
+#include "TypeScript/MemoryStats.h"
 #include "TypeScript/Defines.h"
 #include "TypeScript/Passes.h"
 #include "TypeScript/TypeScriptDialect.h"
@@ -174,15 +175,15 @@ class PrintOpLowering : public TsLlvmPattern<mlir_ts::PrintOp>
             else if (llvmType.isInteger(1))
             {
                 values.push_back(rewriter.create<LLVM::SelectOp>(
-                    item.getLoc(), item, ch.getOrCreateGlobalString("__true__", std::string("true")),
-                    ch.getOrCreateGlobalString("__false__", std::string("false"))));
+                    item.getLoc(), item, ch.getOrCreateGlobalString(std::string("true")),
+                    ch.getOrCreateGlobalString(std::string("false"))));
             }
             else if (auto o = type.dyn_cast<mlir_ts::OptionalType>())
             {
                 auto boolPart = rewriter.create<mlir_ts::HasValueOp>(item.getLoc(), th.getBooleanType(), item);
                 values.push_back(rewriter.create<LLVM::SelectOp>(
-                    item.getLoc(), boolPart, ch.getOrCreateGlobalString("__true__", std::string("true")),
-                    ch.getOrCreateGlobalString("__false__", std::string("false"))));
+                    item.getLoc(), boolPart, ch.getOrCreateGlobalString(std::string("true")),
+                    ch.getOrCreateGlobalString(std::string("false"))));
                 auto optVal = rewriter.create<mlir_ts::ValueOp>(item.getLoc(), o.getElementType(), item);
                 fval(optVal.getType(), optVal);
             }
@@ -302,10 +303,37 @@ class ParseIntOpLowering : public TsLlvmPattern<mlir_ts::ParseIntOp>
         
 
         TypeHelper th(rewriter);
+        TypeConverterHelper tch(getTypeConverter());
         LLVMCodeHelper ch(op, rewriter, getTypeConverter(), tsLlvmContext->compileOptions);
+        CodeLogicHelper clh(op, rewriter);
+
+        auto loc = op->getLoc();
 
-        // Insert the `atoi` declaration if necessary.
         auto i8PtrTy = th.getI8PtrType();
+
+        ConvertLogic cl(op, rewriter, tch, loc, tsLlvmContext->compileOptions);
+        if (cl.isRuntimeAvailable())
+        {
+            // ECMAScript parseInt (whitespaces, sign, 0x prefix, radix 2-36), radix 0 is not set
+            auto parseIntFuncOp = ch.getOrInsertFunction(
+                "ts_parse_int", th.getFunctionType(rewriter.getI64Type(), {i8PtrTy, rewriter.getI32Type()}));
+            mlir::Value base = transformed.getBase() ? transformed.getBase() : clh.createI32ConstantOf(0);
+            auto funcCall = rewriter.create<LLVM::CallOp>(loc, parseIntFuncOp, ValueRange{transformed.getArg(), base});
+
+            auto resultType = tch.convertType(op.getType());
+            if (resultType.isInteger(64))
+            {
+                rewriter.replaceOp(op, funcCall.getResult());
+            }
+            else
+            {
+                rewriter.replaceOpWithNewOp<LLVM::TruncOp>(op, resultType, funcCall.getResult());
+            }
+
+            return success();
+        }
+
+        // Insert the `atoi` declaration if necessary.
         LLVM::LLVMFuncOp parseIntFuncOp;
         if (transformed.getBase())
         {
@@ -337,13 +365,18 @@ class ParseFloatOpLowering : public TsLlvmPattern<mlir_ts::ParseFloatOp>
         
 
         TypeHelper th(rewriter);
+        TypeConverterHelper tch(getTypeConverter());
         LLVMCodeHelper ch(op, rewriter, getTypeConverter(), tsLlvmContext->compileOptions);
 
         auto loc = op->getLoc();
 
-        // Insert the `atof` declaration if necessary.
+        // ECMAScript parseFloat from runtime library (locale independent, NaN when there is no number), `atof` otherwise
+        ConvertLogic cl(op, rewriter, tch, loc, tsLlvmContext->compileOptions);
+        auto parseFloatFuncName = cl.isRuntimeAvailable() ? "ts_parse_float" : "atof";
+
+        // Insert the declaration if necessary.
         auto i8PtrTy = th.getI8PtrType();
-        auto parseFloatFuncOp = ch.getOrInsertFunction("atof", th.getFunctionType(rewriter.getF64Type(), {i8PtrTy}));
+        auto parseFloatFuncOp = ch.getOrInsertFunction(parseFloatFuncName, th.getFunctionType(rewriter.getF64Type(), {i8PtrTy}));
 
 #ifdef NUMBER_F64
         auto funcCall = rewriter.replaceOpWithNewOp<LLVM::CallOp>(op, parseFloatFuncOp, ValueRange{transformed.getArg()});
@@ -483,6 +516,58 @@ class LengthOfOpLowering : public TsLlvmPattern<mlir_ts::LengthOfOp>
     }
 };
 
+// value of string literal is known at compile time
+std::optional<StringRef> getConstString(mlir::Value value)
+{
+    if (auto constantOp = value.getDefiningOp<mlir_ts::ConstantOp>())
+    {
+        if (auto strAttr = constantOp.getValue().dyn_cast_or_null<mlir::StringAttr>())
+        {
+            return strAttr.getValue();
+        }
+    }
+
+    return std::nullopt;
+}
+
+// length of string literal is known at compile time, no need to scan it
+std::optional<int64_t> getConstStringLength(mlir::Value value)
+{
+    if (auto constString = getConstString(value))
+    {
+        // string is read as C string, so it ends at first null
+        return constString.value().take_until([](char c) { return c == '\0'; }).size();
+    }
+
+    return std::nullopt;
+}
+
+// sizes of strings, every string is scanned once, literals are not scanned at all
+SmallVector<mlir::Value> getStringSizes(mlir::Location loc, mlir::ValueRange origValues, mlir::ValueRange values,
+                                        ConversionPatternRewriter &rewriter, CodeLogicHelper &clh, LLVMCodeHelper &ch,
+                                        TypeConverterHelper &tch)
+{
+    TypeHelper th(rewriter);
+
+    auto llvmIndexType = tch.convertType(th.getIndexType());
+    auto strlenFuncOp = ch.getOrInsertFunction("strlen", th.getFunctionType(llvmIndexType, {th.getI8PtrType()}));
+
+    SmallVector<mlir::Value> sizes;
+    for (auto [value, origValue] : llvm::zip(values, origValues))
+    {
+        if (auto constLength = getConstStringLength(origValue))
+        {
+            sizes.push_back(clh.createIndexConstantOf(llvmIndexType, constLength.value()));
+        }
+        else
+        {
+            sizes.push_back(rewriter.create<LLVM::CallOp>(loc, strlenFuncOp, value).getResult());
+        }
+    }
+
+    return sizes;
+}
+
 class StringLengthOpLowering : public TsLlvmPattern<mlir_ts::StringLengthOp>
 {
   public:
@@ -494,6 +579,7 @@ class StringLengthOpLowering : public TsLlvmPattern<mlir_ts::StringLengthOp>
         
 
         TypeHelper th(rewriter);
+        CodeLogicHelper clh(op, rewriter);
         LLVMCodeHelper ch(op, rewriter, getTypeConverter(), tsLlvmContext->compileOptions);
         TypeConverterHelper tch(getTypeConverter());
 
@@ -501,6 +587,12 @@ class StringLengthOpLowering : public TsLlvmPattern<mlir_ts::StringLengthOp>
         auto i8PtrTy = th.getI8PtrType();
         auto llvmIndexType = tch.convertType(th.getIndexType());
 
+        if (auto constLength = getConstStringLength(op.getOp()))
+        {
+            rewriter.replaceOp(op, ValueRange{clh.createI32ConstantOf(constLength.value())});
+            return success();
+        }
+
         auto strlenFuncOp = ch.getOrInsertFunction("strlen", th.getFunctionType(llvmIndexType, {i8PtrTy}));
 
         // calc size
@@ -535,47 +627,100 @@ class StringConcatOpLowering : public TsLlvmPattern<mlir_ts::StringConcatOp>
 
         auto loc = op->getLoc();
 
-        // TODO implement str concat
         auto i8PtrTy = th.getI8PtrType();
-        auto i8PtrPtrTy = th.getI8PtrPtrType();
         auto llvmIndexType = tch.convertType(th.getIndexType());
 
-        auto strlenFuncOp = ch.getOrInsertFunction("strlen", th.getFunctionType(llvmIndexType, {i8PtrTy}));
-        auto strcpyFuncOp = ch.getOrInsertFunction("strcpy", th.getFunctionType(i8PtrTy, {i8PtrTy, i8PtrTy}));
-        auto strcatFuncOp = ch.getOrInsertFunction("strcat", th.getFunctionType(i8PtrTy, {i8PtrTy, i8PtrTy}));
+        auto copyMemFuncOp = ch.getOrInsertFunction(
+            llvmIndexType.getIntOrFloatBitWidth() == 32 
+                ? "llvm.memcpy.p0.p0.i32" 
+                : "llvm.memcpy.p0.p0.i64", 
+            th.getFunctionType(th.getVoidType(), {i8PtrTy, i8PtrTy, llvmIndexType, th.getLLVMBoolType()}));
 
-        mlir::Value size = clh.createIndexConstantOf(llvmIndexType, 1);
         // calc size
-        for (auto oper : transformed.getOps())
+        auto sizes = getStringSizes(loc, op.getOps(), transformed.getOps(), rewriter, clh, ch, tch);
+        mlir::Value size = clh.createIndexConstantOf(llvmIndexType, 1);
+        for (auto size1 : sizes)
         {
-            auto size1 = rewriter.create<LLVM::CallOp>(loc, strlenFuncOp, oper);
-            size = rewriter.create<LLVM::AddOp>(loc, llvmIndexType, ValueRange{size, size1.getResult()});
+            size = rewriter.create<LLVM::AddOp>(loc, llvmIndexType, ValueRange{size, size1});
         }
 
         auto allocInStack = op.getAllocInStack().has_value() && op.getAllocInStack().value();
 
         mlir::Value newStringValue = allocInStack ? rewriter.create<LLVM::AllocaOp>(loc, i8PtrTy, size, true)
-                                                  : ch.MemoryAllocBitcast(i8PtrTy, size);
+                                                  : ch.MemoryAllocBitcast(i8PtrTy, size, MemoryAllocSet::Atomic);
 
-        // copy
-        auto concat = false;
-        auto result = newStringValue;
-        for (auto oper : transformed.getOps())
+        // copy, each part is placed at known offset
+        auto immarg = clh.createI1ConstantOf(false);
+        mlir::Value dest = newStringValue;
+        for (auto [oper, size1] : llvm::zip(transformed.getOps(), sizes))
         {
-            if (concat)
-            {
-                auto callResult = rewriter.create<LLVM::CallOp>(loc, strcatFuncOp, ValueRange{result, oper});
-                result = callResult.getResult();
-            }
-            else
-            {
-                auto callResult = rewriter.create<LLVM::CallOp>(loc, strcpyFuncOp, ValueRange{result, oper});
-                result = callResult.getResult();
-            }
-
-            concat = true;
+            rewriter.create<LLVM::CallOp>(loc, copyMemFuncOp, ValueRange{dest, oper, size1, immarg});
+            dest = rewriter.create<LLVM::GEPOp>(loc, i8PtrTy, dest, ValueRange{size1});
         }
 
+        // end of string
+        rewriter.create<LLVM::StoreOp>(loc, clh.createI8ConstantOf(0), dest);
+
+        rewriter.replaceOp(op, ValueRange{newStringValue});
+
+        return success();
+    }
+};
+
+class StringBuilderOpLowering : public TsLlvmPattern<mlir_ts::StringBuilderOp>
+{
+  public:
+    using TsLlvmPattern<mlir_ts::StringBuilderOp>::TsLlvmPattern;
+
+    LogicalResult matchAndRewrite(mlir_ts::StringBuilderOp op, Adaptor transformed,
+                                  ConversionPatternRewriter &rewriter) const final
+    {
+        CodeLogicHelper clh(op, rewriter);
+        LLVMCodeHelper ch(op, rewriter, getTypeConverter(), tsLlvmContext->compileOptions);
+        TypeConverterHelper tch(getTypeConverter());
+
+        auto loc = op->getLoc();
+
+        TypeHelper th(rewriter);
+        StringBuilderLogic sbl(op, rewriter, tch, loc, tsLlvmContext->compileOptions);
+
+        // string which is not set yet stays as it is
+        auto i8PtrTy = th.getI8PtrType();
+        auto nullValue = rewriter.create<LLVM::NullOp>(loc, i8PtrTy);
+        auto isNull = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, transformed.getOp(), nullValue);
+        auto newStringValue = clh.conditionalExpressionLowering(
+            loc, i8PtrTy, isNull, [&](OpBuilder &builder, Location loc) { return nullValue; },
+            [&](OpBuilder &builder, Location loc) {
+                auto sizes =
+                    getStringSizes(loc, op->getOperands(), transformed.getOperands(), rewriter, clh, ch, tch);
+                return sbl.create(transformed.getOp(), sizes.front());
+            });
+
+        rewriter.replaceOp(op, ValueRange{newStringValue});
+
+        return success();
+    }
+};
+
+class StringAppendOpLowering : public TsLlvmPattern<mlir_ts::StringAppendOp>
+{
+  public:
+    using TsLlvmPattern<mlir_ts::StringAppendOp>::TsLlvmPattern;
+
+    LogicalResult matchAndRewrite(mlir_ts::StringAppendOp op, Adaptor transformed,
+                                  ConversionPatternRewriter &rewriter) const final
+    {
+        CodeLogicHelper clh(op, rewriter);
+        LLVMCodeHelper ch(op, rewriter, getTypeConverter(), tsLlvmContext->compileOptions);
+        TypeConverterHelper tch(getTypeConverter());
+
+        auto loc = op->getLoc();
+
+        auto sizes = getStringSizes(loc, op.getOps(), transformed.getOps(), rewriter, clh, ch, tch);
+
+        StringBuilderLogic sbl(op, rewriter, tch, loc, tsLlvmContext->compileOptions);
+        auto newStringValue = sbl.append(transformed.getOp(), transformed.getOps(), sizes);
+
         rewriter.replaceOp(op, ValueRange{newStringValue});
 
         return success();
@@ -601,6 +746,29 @@ class StringCompareOpLowering : public TsLlvmPattern<mlir_ts::StringCompareOp>
 
         auto i8PtrTy = th.getI8PtrType();
 
+        auto predicate = getPredicate((SyntaxKind)op.getCode());
+        auto isEquality = predicate == LLVM::ICmpPredicate::eq || predicate == LLVM::ICmpPredicate::ne;
+
+        // type guards (typeof x === "number", tags of unions and any) and other compares with short literals
+        if (isEquality)
+        {
+            auto literal1 = getConstString(op.getOp1());
+            auto literal2 = getConstString(op.getOp2());
+            if (literal2 && literal2.value().size() <= STRING_COMPARE_INLINE_MAX_LENGTH)
+            {
+                rewriter.replaceOp(op, compareWithLiteral(loc, predicate, transformed.getOp1(), transformed.getOp2(),
+                                                          literal2.value(), rewriter));
+                return success();
+            }
+
+            if (literal1 && literal1.value().size() <= STRING_COMPARE_INLINE_MAX_LENGTH)
+            {
+                rewriter.replaceOp(op, compareWithLiteral(loc, predicate, transformed.getOp2(), transformed.getOp1(),
+                                                          literal1.value(), rewriter));
+                return success();
+            }
+        }
+
         // compare bodies
         auto strcmpFuncOp = ch.getOrInsertFunction("strcmp", th.getFunctionType(th.getI32Type(), {i8PtrTy, i8PtrTy}));
 
@@ -617,92 +785,139 @@ class StringCompareOpLowering : public TsLlvmPattern<mlir_ts::StringCompareOp>
         auto const0I32 = clh.createI32ConstantOf(0);
         auto ptrCmpResult = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::ne, cmpResult, const0I32);
 
+        // the same string (equal literals share one global) is answered by pointers
+        auto notSamePtr = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::ne, leftPtrValue, rightPtrValue);
+        mlir::Value bodyCmpNeeded = rewriter.create<LLVM::AndOp>(loc, ptrCmpResult, notSamePtr);
+
+        if (isEquality)
+        {
+            // strings with different first chars are not equal
+            bodyCmpNeeded = clh.conditionalExpressionLowering(
+                loc, th.getLLVMBoolType(), bodyCmpNeeded,
+                [&](OpBuilder &builder, Location loc) {
+                    auto firstChar1 = rewriter.create<LLVM::LoadOp>(loc, transformed.getOp1());
+                    auto firstChar2 = rewriter.create<LLVM::LoadOp>(loc, transformed.getOp2());
+                    return rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, firstChar1, firstChar2);
+                },
+                [&](OpBuilder &builder, Location loc) { return bodyCmpNeeded; });
+        }
+
         auto result = clh.conditionalExpressionLowering(
-            loc, th.getBooleanType(), ptrCmpResult,
+            loc, th.getBooleanType(), bodyCmpNeeded,
             [&](OpBuilder &builder, Location loc) {
-                // both not null
+                // both not null and not the same
                 auto const0 = clh.createI32ConstantOf(0);
                 auto compareResult =
                     rewriter.create<LLVM::CallOp>(loc, strcmpFuncOp, ValueRange{transformed.getOp1(), transformed.getOp2()});
 
                 // else compare body
-                mlir::Value bodyCmpResult;
-                switch ((SyntaxKind)op.getCode())
-                {
-                case SyntaxKind::EqualsEqualsToken:
-                case SyntaxKind::EqualsEqualsEqualsToken:
-                    bodyCmpResult =
-                        rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, compareResult.getResult(), const0);
-                    break;
-                case SyntaxKind::ExclamationEqualsToken:
-                case SyntaxKind::ExclamationEqualsEqualsToken:
-                    bodyCmpResult =
-                        rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::ne, compareResult.getResult(), const0);
-                    break;
-                case SyntaxKind::GreaterThanToken:
-                    bodyCmpResult = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::sgt,
-                                                                  compareResult.getResult(), const0);
-                    break;
-                case SyntaxKind::GreaterThanEqualsToken:
-                    bodyCmpResult = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::sge,
-                                                                  compareResult.getResult(), const0);
-                    break;
-                case SyntaxKind::LessThanToken:
-                    bodyCmpResult = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::slt,
-                                                                  compareResult.getResult(), const0);
-                    break;
-                case SyntaxKind::LessThanEqualsToken:
-                    bodyCmpResult = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::sle,
-                                                                  compareResult.getResult(), const0);
-                    break;
-                default:
-                    llvm_unreachable("not implemented");
-                }
-
-                return bodyCmpResult;
+                return rewriter.create<LLVM::ICmpOp>(loc, predicate, compareResult.getResult(), const0);
             },
             [&](OpBuilder &builder, Location loc) {
-                // else compare body
-                mlir::Value ptrCmpResult;
-                switch ((SyntaxKind)op.getCode())
-                {
-                case SyntaxKind::EqualsEqualsToken:
-                case SyntaxKind::EqualsEqualsEqualsToken:
-                    ptrCmpResult =
-                        rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, leftPtrValue, rightPtrValue);
-                    break;
-                case SyntaxKind::ExclamationEqualsToken:
-                case SyntaxKind::ExclamationEqualsEqualsToken:
-                    ptrCmpResult =
-                        rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::ne, leftPtrValue, rightPtrValue);
-                    break;
-                case SyntaxKind::GreaterThanToken:
-                    ptrCmpResult =
-                        rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::sgt, leftPtrValue, rightPtrValue);
-                    break;
-                case SyntaxKind::GreaterThanEqualsToken:
-                    ptrCmpResult =
-                        rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::sge, leftPtrValue, rightPtrValue);
-                    break;
-                case SyntaxKind::LessThanToken:
-                    ptrCmpResult =
-                        rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::slt, leftPtrValue, rightPtrValue);
-                    break;
-                case SyntaxKind::LessThanEqualsToken:
-                    ptrCmpResult =
-                        rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::sle, leftPtrValue, rightPtrValue);
-                    break;
-                default:
-                    llvm_unreachable("not implemented");
-                }
-
-                return ptrCmpResult;
+                // null, the same string or different first chars: pointers give result
+                return rewriter.create<LLVM::ICmpOp>(loc, predicate, leftPtrValue, rightPtrValue);
             });
 
         rewriter.replaceOp(op, result);
 
         return success();
     }
+
+  private:
+    // literal is never null and has one global per value in module: the same pointer is equal string (so matching type
+    // tag costs one compare), otherwise chars of literal are compared inline up to first different char
+    mlir::Value compareWithLiteral(mlir::Location loc, LLVM::ICmpPredicate predicate, mlir::Value value,
+                                   mlir::Value literalValue, StringRef literal,
+                                   ConversionPatternRewriter &rewriter) const
+    {
+        TypeHelper th(rewriter);
+        CodeLogicHelper clh(loc, rewriter);
+
+        auto i8PtrTy = th.getI8PtrType();
+        auto boolType = th.getLLVMBoolType();
+
+        // Split block
+        auto *opBlock = rewriter.getInsertionBlock();
+        auto opPosition = rewriter.getInsertionPoint();
+        auto *continuationBlock = rewriter.splitBlock(opBlock, opPosition);
+
+        // result block
+        auto *resultBlock = rewriter.createBlock(continuationBlock, TypeRange{boolType}, {loc});
+        rewriter.create<LLVM::BrOp>(loc, ValueRange{}, continuationBlock);
+
+        // literal is read as C string, chars after embedded null are not part of it
+        literal = literal.take_until([](char c) { return c == '\0'; });
+
+        // one block per char of literal including terminating null
+        SmallVector<Block *> charBlocks;
+        for (size_t index = 0; index <= literal.size(); index++)
+        {
+            charBlocks.push_back(rewriter.createBlock(resultBlock));
+        }
+
+        rewriter.setInsertionPointToEnd(opBlock);
+        auto nullValue = rewriter.create<LLVM::NullOp>(loc, i8PtrTy);
+        auto samePtr = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, value, literalValue);
+        auto isNull = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, value, nullValue);
+        auto answered = rewriter.create<LLVM::OrOp>(loc, samePtr, isNull);
+        rewriter.create<LLVM::CondBrOp>(loc, answered, resultBlock, ValueRange{samePtr}, charBlocks.front(),
+                                        ValueRange{});
+
+        for (auto [index, charBlock] : llvm::enumerate(charBlocks))
+        {
+            rewriter.setInsertionPointToEnd(charBlock);
+
+            auto charPtr = rewriter.create<LLVM::GEPOp>(loc, i8PtrTy, value,
+                                                        ValueRange{clh.createI32ConstantOf(index)});
+            auto charValue = rewriter.create<LLVM::LoadOp>(loc, charPtr);
+            auto literalChar = index < literal.size() ? (int8_t)literal[index] : 0;
+            auto isEqual = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, charValue,
+                                                         clh.createI8ConstantOf(literalChar));
+            if (index < literal.size())
+            {
+                // string is not shorter than literal here, so next char can be read
+                rewriter.create<LLVM::CondBrOp>(loc, isEqual, charBlocks[index + 1], ValueRange{}, resultBlock,
+                                                ValueRange{isEqual});
+            }
+            else
+            {
+                rewriter.create<LLVM::BrOp>(loc, ValueRange{isEqual}, resultBlock);
+            }
+        }
+
+        rewriter.setInsertionPointToStart(continuationBlock);
+
+        mlir::Value result = resultBlock->getArgument(0);
+        if (predicate == LLVM::ICmpPredicate::ne)
+        {
+            result = rewriter.create<LLVM::XOrOp>(loc, result, clh.createI1ConstantOf(true));
+        }
+
+        return result;
+    }
+
+    static LLVM::ICmpPredicate getPredicate(SyntaxKind code)
+    {
+        switch (code)
+        {
+        case SyntaxKind::EqualsEqualsToken:
+        case SyntaxKind::EqualsEqualsEqualsToken:
+            return LLVM::ICmpPredicate::eq;
+        case SyntaxKind::ExclamationEqualsToken:
+        case SyntaxKind::ExclamationEqualsEqualsToken:
+            return LLVM::ICmpPredicate::ne;
+        case SyntaxKind::GreaterThanToken:
+            return LLVM::ICmpPredicate::sgt;
+        case SyntaxKind::GreaterThanEqualsToken:
+            return LLVM::ICmpPredicate::sge;
+        case SyntaxKind::LessThanToken:
+            return LLVM::ICmpPredicate::slt;
+        case SyntaxKind::LessThanEqualsToken:
+            return LLVM::ICmpPredicate::sle;
+        default:
+            llvm_unreachable("not implemented");
+        }
+    }
 };
 
 class CharToStringOpLowering : public TsLlvmPattern<mlir_ts::CharToStringOp>
@@ -1515,7 +1730,7 @@ struct BoxOpLowering : public TsLlvmPattern<mlir_ts::BoxOp>
         auto in = transformed.getIn();
 
         AnyLogic al(op, rewriter, tch, loc, tsLlvmContext->compileOptions);
-        auto result = al.castToAny(in, transformed.getTypeInfo(), in.getType());
+        auto result = al.castToAny(in, transformed.getTypeInfo(), in.getType(), getConstString(op.getTypeInfo()));
 
         rewriter.replaceOp(op, result);
 
@@ -1750,7 +1965,8 @@ struct VariableOpLowering : public TsLlvmPattern<mlir_ts::VariableOp>
         else
         {
 
-            allocated = ch.MemoryAllocBitcast(llvmReferenceType, storageType);
+            allocated = ch.MemoryAllocBitcast(llvmReferenceType, storageType,
+                                              ch.getMemoryAllocSet(tch.convertType(storageType)));
         }
 
 #ifdef GC_ENABLE
@@ -1893,11 +2109,37 @@ struct NewOpLowering : public TsLlvmPattern<mlir_ts::NewOp>
         mlir::Value value;
         if (newOp.getStackAlloc().has_value() && newOp.getStackAlloc().value())
         {
-            value = rewriter.create<LLVM::AllocaOp>(loc, resultType, clh.createI32ConstantOf(1));
+            // put alloc at 'func' top only when escape analysis proved that instance is not used after next execution
+            // of 'new' (in loop), otherwise instances kept from previous iterations would share one slot
+            auto parentFuncOp = newOp->getParentOfType<LLVM::LLVMFuncOp>();
+            if (parentFuncOp && newOp->hasAttr(REUSE_STACK_SLOT_ATTR_NAME))
+            {
+                mlir::OpBuilder::InsertionGuard insertGuard(rewriter);
+                rewriter.setInsertionPoint(&parentFuncOp.getBody().front().front());
+                value = rewriter.create<LLVM::AllocaOp>(loc, resultType, clh.createI32ConstantOf(1));
+            }
+            else
+            {
+                value = rewriter.create<LLVM::AllocaOp>(loc, resultType, clh.createI32ConstantOf(1));
+            }
+
+            // each 'new' gets clean instance, the same as from memory allocator
+            ch.MemoryZero(value, storageType);
         }
         else
         {
-            value = ch.MemoryAllocBitcast(resultType, storageType, MemoryAllocSet::Zero);
+            mlir::Type llvmStorageType = resultType;
+            if (auto classType = storageType.dyn_cast<mlir_ts::ClassType>())
+            {
+                llvmStorageType = tch.convertType(classType.getStorageType());
+            }
+            else if (auto valueRefType = storageType.dyn_cast<mlir_ts::ValueRefType>())
+            {
+                llvmStorageType = tch.convertType(valueRefType.getElementType());
+            }
+
+            value = ch.MemoryAllocBitcast(resultType, storageType,
+                                          ch.getMemoryAllocSet(llvmStorageType, MemoryAllocSet::Zero));
         }
 
         rewriter.replaceOp(newOp, ValueRange{value});
@@ -2048,7 +2290,9 @@ struct CreateArrayOpLowering : public TsLlvmPattern<mlir_ts::CreateArrayOp>
         auto multSizeOfTypeValue =
             rewriter.create<LLVM::MulOp>(loc, llvmIndexType, ValueRange{sizeOfTypeValue, newCountAsIndexType});
 
-        auto allocated = ch.MemoryAllocBitcast(llvmPtrElementType, multSizeOfTypeValue);
+        // all items are set below
+        auto allocated =
+            ch.MemoryAllocBitcast(llvmPtrElementType, multSizeOfTypeValue, ch.getMemoryAllocSet(llvmElementType));
 
         mlir::Value index = clh.createIndexConstantOf(llvmIndexType, 0);
         auto next = false;
@@ -2177,7 +2421,16 @@ struct NewArrayOpLowering : public TsLlvmPattern<mlir_ts::NewArrayOp>
         auto multSizeOfTypeValue =
             rewriter.create<LLVM::MulOp>(loc, llvmIndexType, ValueRange{sizeOfTypeValue, countAsIndexType});
 
-        auto allocated = ch.MemoryAllocBitcast(llvmPtrElementType, multSizeOfTypeValue);
+        // items are not set, they must be cleared; GC_malloc clears memory itself, only atomic memory and memory
+        // from malloc (no GC) need memset
+        auto gcClearsMemory = !tsLlvmContext->compileOptions.disableGC && !tsLlvmContext->compileOptions.isWasm;
+        auto allocSet = ch.getMemoryAllocSet(llvmElementType, MemoryAllocSet::Zero);
+        if (allocSet == MemoryAllocSet::Zero && gcClearsMemory)
+        {
+            allocSet = MemoryAllocSet::None;
+        }
+
+        auto allocated = ch.MemoryAllocBitcast(llvmPtrElementType, multSizeOfTypeValue, allocSet);
 
         // create array type
         auto llvmRtArrayStructType = tch.convertType(arrayType);
@@ -2238,7 +2491,15 @@ struct PushOpLowering : public TsLlvmPattern<mlir_ts::PushOp>
         auto multSizeOfTypeValue =
             rewriter.create<LLVM::MulOp>(loc, llvmIndexType, ValueRange{sizeOfTypeValue, newCountAsIndexType});
 
-        auto allocated = ch.MemoryReallocBitcast(llvmPtrElementType, currentPtr, multSizeOfTypeValue);
+        mlir::Value allocated;
+        if (!tsLlvmContext->compileOptions.disableGC && !tsLlvmContext->compileOptions.isWasm)
+        {
+            allocated = growGeometrically(loc, llvmPtrElementType, currentPtr, multSizeOfTypeValue, ch, rewriter);
+        }
+        else
+        {
+            allocated = ch.MemoryReallocBitcast(llvmPtrElementType, currentPtr, multSizeOfTypeValue);
+        }
 
         mlir::Value index = countAsIndexType;
         auto next = false;
@@ -2286,6 +2547,45 @@ struct PushOpLowering : public TsLlvmPattern<mlir_ts::PushOp>
         rewriter.replaceOp(pushOp, ValueRange{newCountAsI32Type});
         return success();
     }
+
+  private:
+    // capacity of array is usable size of its GC block (GC_size), so layout of array stays { data, length }; block is
+    // reallocated only when it is full and then at least doubled, so n pushes cost O(n) copies in total
+    mlir::Value growGeometrically(mlir::Location loc, mlir::Type llvmPtrElementType, mlir::Value currentPtr,
+                                  mlir::Value requiredSize, LLVMCodeHelper &ch,
+                                  ConversionPatternRewriter &rewriter) const
+    {
+        CodeLogicHelper clh(loc, rewriter);
+        TypeConverterHelper tch(getTypeConverter());
+        TypeHelper th(rewriter);
+
+        auto llvmIndexType = tch.convertType(th.getIndexType());
+        auto i8PtrTy = th.getI8PtrType();
+
+        auto gcSizeFuncOp = ch.getOrInsertFunction("GC_size", th.getFunctionType(llvmIndexType, {i8PtrTy}));
+
+        auto currentPtrAsI8Ptr = rewriter.create<LLVM::BitcastOp>(loc, i8PtrTy, currentPtr);
+        auto nullPtr = rewriter.create<LLVM::NullOp>(loc, i8PtrTy);
+        auto isNull = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, currentPtrAsI8Ptr, nullPtr);
+        auto capacity = clh.conditionalExpressionLowering(
+            loc, llvmIndexType, isNull,
+            [&](OpBuilder &builder, Location loc) { return clh.createIndexConstantOf(llvmIndexType, 0); },
+            [&](OpBuilder &builder, Location loc) {
+                return rewriter.create<LLVM::CallOp>(loc, gcSizeFuncOp, ValueRange{currentPtrAsI8Ptr}).getResult();
+            });
+
+        auto notEnough = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::ugt, requiredSize, capacity);
+        return clh.conditionalExpressionLowering(
+            loc, llvmPtrElementType, notEnough,
+            [&](OpBuilder &builder, Location loc) {
+                auto two = clh.createIndexConstantOf(llvmIndexType, 2);
+                auto doubled = rewriter.create<LLVM::MulOp>(loc, llvmIndexType, ValueRange{capacity, two});
+                auto isDoubledEnough = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::ugt, doubled, requiredSize);
+                auto newSize = rewriter.create<LLVM::SelectOp>(loc, isDoubledEnough, doubled, requiredSize);
+                return ch.MemoryReallocBitcast(llvmPtrElementType, currentPtr, newSize);
+            },
+            [&](OpBuilder &builder, Location loc) { return currentPtr; });
+    }
 };
 
 struct PopOpLowering : public TsLlvmPattern<mlir_ts::PopOp>
@@ -2340,12 +2640,23 @@ struct PopOpLowering : public TsLlvmPattern<mlir_ts::PopOp>
         auto sizeOfTypeValueMLIR = rewriter.create<mlir_ts::SizeOfOp>(loc, th.getIndexType(), storageType);
         auto sizeOfTypeValue = rewriter.create<mlir_ts::DialectCastOp>(loc, llvmIndexType, sizeOfTypeValueMLIR);
 
-        auto multSizeOfTypeValue =
-            rewriter.create<LLVM::MulOp>(loc, llvmIndexType, ValueRange{sizeOfTypeValue, newCountAsIndexType});
+        if (!tsLlvmContext->compileOptions.disableGC && !tsLlvmContext->compileOptions.isWasm)
+        {
+            // block keeps its size as capacity for next pushes, released slot must not keep object alive
+            if (!th.isPointerFree(llvmElementType))
+            {
+                ch.MemoryZero(offset, llvmElementType);
+            }
+        }
+        else
+        {
+            auto multSizeOfTypeValue =
+                rewriter.create<LLVM::MulOp>(loc, llvmIndexType, ValueRange{sizeOfTypeValue, newCountAsIndexType});
 
-        auto allocated = ch.MemoryReallocBitcast(llvmPtrElementType, currentPtr, multSizeOfTypeValue);
+            auto allocated = ch.MemoryReallocBitcast(llvmPtrElementType, currentPtr, multSizeOfTypeValue);
 
-        rewriter.create<LLVM::StoreOp>(loc, allocated, currentPtrPtr);
+            rewriter.create<LLVM::StoreOp>(loc, allocated, currentPtrPtr);
+        }
 
         auto newCountAsI32Type = 
             newCountAsIndexType.getType() != th.getI32Type()
@@ -3033,8 +3344,6 @@ struct OptionalOpLowering : public TsLlvmPattern<mlir_ts::OptionalOp>
         auto value = transformed.getIn();
         auto valueLLVMType = value.getType();
 
-        auto structValue = rewriter.create<LLVM::UndefOp>(loc, llvmOptType);
-
         // TODO: it should be tested by OP that value is equal to value in optional type
         if (valueLLVMType != llvmBoxedType)
         {
@@ -3052,6 +3361,14 @@ struct OptionalOpLowering : public TsLlvmPattern<mlir_ts::OptionalOp>
             value = rewriter.create<mlir_ts::DialectCastOp>(loc, llvmBoxedType, value);
         }
 
+        if (TypeConverterHelper::isNullNicheOptional(optionalOp.getRes().getType().cast<mlir_ts::OptionalType>()))
+        {
+            auto nullValue = rewriter.create<LLVM::NullOp>(loc, llvmOptType);
+            rewriter.replaceOpWithNewOp<LLVM::SelectOp>(optionalOp, transformed.getFlag(), value, nullValue);
+            return success();
+        }
+
+        auto structValue = rewriter.create<LLVM::UndefOp>(loc, llvmOptType);
         auto structValue2 = rewriter.create<LLVM::InsertValueOp>(loc, llvmOptType, structValue, value,
                                                                  MLIRHelper::getStructIndex(rewriter, OPTIONAL_VALUE_INDEX));
 
@@ -3088,8 +3405,6 @@ struct ValueOptionalOpLowering : public TsLlvmPattern<mlir_ts::OptionalValueOp>
         auto value = transformed.getIn();
         auto valueLLVMType = value.getType();
 
-        auto structValue = rewriter.create<LLVM::UndefOp>(loc, llvmOptType);
-
         // TODO: it should be tested by OP that value is equal to value in optional type
         if (valueLLVMType != llvmBoxedType)
         {
@@ -3107,6 +3422,13 @@ struct ValueOptionalOpLowering : public TsLlvmPattern<mlir_ts::OptionalValueOp>
             value = rewriter.create<mlir_ts::DialectCastOp>(loc, llvmBoxedType, value);
         }
 
+        if (TypeConverterHelper::isNullNicheOptional(createOptionalOp.getRes().getType().cast<mlir_ts::OptionalType>()))
+        {
+            rewriter.replaceOp(createOptionalOp, value);
+            return success();
+        }
+
+        auto structValue = rewriter.create<LLVM::UndefOp>(loc, llvmOptType);
         auto structValue2 = rewriter.create<LLVM::InsertValueOp>(loc, llvmOptType, structValue, value,
                                                                  MLIRHelper::getStructIndex(rewriter, OPTIONAL_VALUE_INDEX));
 
@@ -3138,6 +3460,12 @@ struct UndefOptionalOpLowering : public TsLlvmPattern<mlir_ts::OptionalUndefOp>
         auto llvmBoxedType = tch.convertType(boxedType);
         auto llvmOptType = tch.convertType(undefOptionalOp.getRes().getType());
 
+        if (TypeConverterHelper::isNullNicheOptional(undefOptionalOp.getRes().getType().cast<mlir_ts::OptionalType>()))
+        {
+            rewriter.replaceOpWithNewOp<LLVM::NullOp>(undefOptionalOp, llvmOptType);
+            return success();
+        }
+
         mlir::Value structValue = rewriter.create<LLVM::UndefOp>(loc, llvmOptType);
         auto structValue2 = structValue;
 
@@ -3157,6 +3485,19 @@ struct UndefOptionalOpLowering : public TsLlvmPattern<mlir_ts::OptionalUndefOp>
     }
 };
 
+// value of optional with null niche is optional itself
+void replaceWithNicheValue(mlir::Operation *op, mlir::Value in, mlir::Type llvmValueType,
+                           ConversionPatternRewriter &rewriter)
+{
+    if (in.getType() == llvmValueType)
+    {
+        rewriter.replaceOp(op, in);
+        return;
+    }
+
+    rewriter.replaceOpWithNewOp<LLVM::BitcastOp>(op, llvmValueType, in);
+}
+
 struct HasValueOpLowering : public TsLlvmPattern<mlir_ts::HasValueOp>
 {
     using TsLlvmPattern<mlir_ts::HasValueOp>::TsLlvmPattern;
@@ -3170,6 +3511,14 @@ struct HasValueOpLowering : public TsLlvmPattern<mlir_ts::HasValueOp>
 
         TypeHelper th(rewriter);
 
+        if (TypeConverterHelper::isNullNicheOptional(hasValueOp.getIn().getType().cast<mlir_ts::OptionalType>()))
+        {
+            auto in = transformed.getIn();
+            auto nullValue = rewriter.create<LLVM::NullOp>(loc, in.getType());
+            rewriter.replaceOpWithNewOp<LLVM::ICmpOp>(hasValueOp, LLVM::ICmpPredicate::ne, in, nullValue);
+            return success();
+        }
+
         rewriter.replaceOpWithNewOp<LLVM::ExtractValueOp>(hasValueOp, th.getLLVMBoolType(), transformed.getIn(),
                                                           MLIRHelper::getStructIndex(rewriter, OPTIONAL_HASVALUE_INDEX));
 
@@ -3191,6 +3540,12 @@ struct ValueOpLowering : public TsLlvmPattern<mlir_ts::ValueOp>
         auto valueType = valueOp.getRes().getType();
         auto llvmValueType = tch.convertType(valueType);
 
+        if (TypeConverterHelper::isNullNicheOptional(valueOp.getIn().getType().cast<mlir_ts::OptionalType>()))
+        {
+            replaceWithNicheValue(valueOp, transformed.getIn(), llvmValueType, rewriter);
+            return success();
+        }
+
         rewriter.replaceOpWithNewOp<LLVM::ExtractValueOp>(valueOp, llvmValueType, transformed.getIn(),
                                                           MLIRHelper::getStructIndex(rewriter, OPTIONAL_VALUE_INDEX));
 
@@ -3216,6 +3571,13 @@ struct ValueOrDefaultOpLowering : public TsLlvmPattern<mlir_ts::ValueOrDefaultOp
         auto valueType = valueOrDefaultOp.getRes().getType();
         auto llvmValueType = tch.convertType(valueType);
 
+        // null is default value of reference
+        if (TypeConverterHelper::isNullNicheOptional(valueOrDefaultOp.getIn().getType().cast<mlir_ts::OptionalType>()))
+        {
+            replaceWithNicheValue(valueOrDefaultOp, transformed.getIn(), llvmValueType, rewriter);
+            return success();
+        }
+
         auto hasValue = rewriter.create<LLVM::ExtractValueOp>(loc, th.getLLVMBoolType(), transformed.getIn(),
                                                           MLIRHelper::getStructIndex(rewriter, OPTIONAL_HASVALUE_INDEX));
         auto value = rewriter.create<LLVM::ExtractValueOp>(loc, llvmValueType, transformed.getIn(),
@@ -4510,6 +4872,12 @@ struct GlobalConstructorOpLowering : public TsLlvmPattern<mlir_ts::GlobalConstru
 
             globalConstructorOp->getParentOp()->walk(visitorAllGlobalConstructs);
 
+            // type descriptors of classes are used by allocations in other constructors, so they are initialized first
+            // (constructors are called in reverse order)
+            std::stable_partition(globalConstructs.begin(), globalConstructs.end(), [](mlir_ts::GlobalConstructorOp op) {
+                return !op.getGlobalName().endswith(TYPE_BITMAP_NAME);
+            });
+
             auto funcType = th.getPointerType(th.getFunctionType(ArrayRef<mlir::Type>{}));
 
             mlir::SmallVector<mlir::Type, 4> llvmTypes;
@@ -5016,7 +5384,12 @@ static void populateTypeScriptConversionPatterns(LLVMTypeConverter &converter, m
         return LLVM::LLVMStructType::getLiteral(type.getContext(), rtInterfaceType, false);
     });
 
-    converter.addConversion([&](mlir_ts::OptionalType type) {
+    converter.addConversion([&](mlir_ts::OptionalType type) -> mlir::Type {
+        if (TypeConverterHelper::isNullNicheOptional(type))
+        {
+            return converter.convertType(type.getElementType());
+        }
+
         SmallVector<mlir::Type> convertedTypes;
 
         TypeHelper th(m.getContext());
@@ -5382,6 +5755,7 @@ void TypeScriptToLLVMLoweringPass::runOnOperation()
         PopOpLowering, DeleteOpLowering, ParseFloatOpLowering, ParseIntOpLowering, IsNaNOpLowering, PrintOpLowering,
         StoreOpLowering, SizeOfOpLowering, InsertPropertyOpLowering, LengthOfOpLowering, StringLengthOpLowering,
         StringConcatOpLowering, StringCompareOpLowering, CharToStringOpLowering, UndefOpLowering, MemoryCopyOpLowering,
+        StringBuilderOpLowering, StringAppendOpLowering,
         LoadSaveValueLowering, ThrowUnwindOpLowering, ThrowCallOpLowering, VariableOpLowering,
         AllocaOpLowering, InvokeOpLowering, InvokeHybridOpLowering, VirtualSymbolRefOpLowering,
         ThisVirtualSymbolRefOpLowering, InterfaceSymbolRefOpLowering, NewInterfaceOpLowering, VTableOffsetRefOpLowering,
@@ -5450,6 +5824,8 @@ void TypeScriptToLLVMLoweringPass::runOnOperation()
 
     cleanupUnrealizedConversionCast(m);
 
+    MemoryStats::recordOpCount("after LLVM lowering", m);
+
     LLVM_DEBUG(llvm::dbgs() << "\n!! AFTER DUMP: \n" << m << "\n";);
 
     LLVM_DEBUG(verifyModule(m););
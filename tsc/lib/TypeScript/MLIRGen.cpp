@@ -11,8 +11,10 @@
 #include "TypeScript/TypeScriptDialect.h"
 #include "TypeScript/TypeScriptOps.h"
 #include "TypeScript/DiagnosticHelper.h"
+#include "TypeScript/MemoryStats.h"
 
 #include "TypeScript/MLIRLogic/MLIRCodeLogic.h"
+#include "TypeScript/MLIRLogic/MLIRDeclarationManifest.h"
 #include "TypeScript/MLIRLogic/MLIRGenContext.h"
 #include "TypeScript/MLIRLogic/MLIRNamespaceGuard.h"
 #include "TypeScript/MLIRLogic/MLIRTypeHelper.h"
@@ -55,6 +57,7 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/TypeSwitch.h"
 #include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SourceMgr.h"
@@ -62,6 +65,7 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/DynamicLibrary.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/BinaryFormat/Dwarf.h"
 //#include "llvm/IR/DebugInfoMetadata.h"
@@ -201,6 +205,9 @@ class MLIRGenImpl
         std::vector<SourceFile> includeFiles;
         std::vector<string> filesToProcess;
 
+        llvm::TimeTraceScope timeScope("Parse", [&]() { return sourceBuf->getBufferIdentifier().str(); });
+        MemoryStatsScope memScope("AST (parser)");
+
         Parser parser;
         auto sourceFile = parser.parseSourceFile(stows(mainSourceFileName.str()), stows(sourceBuf->getBuffer().str()), ScriptTarget::Latest);
 
@@ -242,6 +249,9 @@ class MLIRGenImpl
 
             const auto *sourceBuf = sourceMgr.getMemoryBuffer(id);
 
+            llvm::TimeTraceScope timeScope("Parse Include", actualFilePath);
+            MemoryStatsScope memScope("AST (parser)");
+
             Parser parser;
             auto includeFile =
                 parser.parseSourceFile(ConvertUTF8toWide(actualFilePath), stows(sourceBuf->getBuffer().str()), ScriptTarget::Latest);
@@ -372,6 +382,28 @@ class MLIRGenImpl
         VariableClass varClass = VariableType::Var;
         varClass.isExport = true;
         registerVariable(mlir::UnknownLoc::get(builder.getContext()), SHARED_LIB_DECLARATIONS, true, varClass, typeWithInit, genContext);
+
+        if (!declManifest.empty())
+        {
+            auto manifestData = declManifest.serialize();
+
+            auto manifestWithInit = [&](mlir::Location location, const GenContext &genContext) {
+                auto litValue = V(mlirGenStringValue(location, manifestData, true));
+                return std::make_tuple(litValue.getType(), litValue, TypeProvided::No);            
+            };
+
+            registerVariable(mlir::UnknownLoc::get(builder.getContext()), SHARED_LIB_DECLARATIONS_MANIFEST, true, varClass, manifestWithInit, genContext);
+
+            // manifest is binary data, reader must not rely on terminating zero
+            auto manifestSizeWithInit = [&](mlir::Location location, const GenContext &genContext) {
+                auto sizeValue = builder.create<mlir_ts::ConstantOp>(location, builder.getI32Type(),
+                                                                     builder.getI32IntegerAttr(manifestData.size()));
+                return std::make_tuple(sizeValue.getType(), mlir::Value(sizeValue), TypeProvided::Yes);
+            };
+
+            registerVariable(mlir::UnknownLoc::get(builder.getContext()), SHARED_LIB_DECLARATIONS_MANIFEST_SIZE, true, varClass, manifestSizeWithInit, genContext);
+        }
+
         return mlir::success();
     }
 
@@ -446,6 +478,9 @@ class MLIRGenImpl
 
     mlir::LogicalResult mlirDiscoverAllDependencies(SourceFile module, std::vector<SourceFile> includeFiles = {})
     {
+        llvm::TimeTraceScope timeScope("Discover Dependencies", [&]() { return convertWideToUTF8(module->fileName); });
+        MemoryStatsScope memScope("MLIRGen discovery (MLIR context, temporary ops)");
+
         mlir::SmallVector<std::unique_ptr<mlir::Diagnostic>> postponedMessages;
         mlir::ScopedDiagnosticHandler diagHandler(builder.getContext(), [&](mlir::Diagnostic &diag) {
             postponedMessages.emplace_back(new mlir::Diagnostic(std::move(diag)));
@@ -499,6 +534,9 @@ class MLIRGenImpl
     mlir::LogicalResult mlirCodeGenModule(SourceFile module, std::vector<SourceFile> includeFiles = {},
                                           bool validate = true)
     {
+        llvm::TimeTraceScope timeScope("CodeGen Module", [&]() { return convertWideToUTF8(module->fileName); });
+        MemoryStatsScope memScope("MLIRGen (MLIR context: attributes, types, ops)");
+
         mlir::SmallVector<std::unique_ptr<mlir::Diagnostic>> postponedWarningsMessages;
         mlir::SmallVector<std::unique_ptr<mlir::Diagnostic>> postponedMessages;
         mlir::ScopedDiagnosticHandler diagHandler(builder.getContext(), [&](mlir::Diagnostic &diag) {
@@ -515,6 +553,7 @@ class MLIRGenImpl
         // Process generating here
         declExports.str(S(""));
         declExports.clear();
+        declManifest.clear();
         exports.str(S(""));
         exports.clear();
         GenContext genContext{};
@@ -546,6 +585,7 @@ class MLIRGenImpl
         // Verify the module after we have finished constructing it, this will check
         // the structural properties of the IR and invoke any specific verifiers we
         // have on the TypeScript operations.
+        llvm::TimeTraceScope verifyTimeScope("Verify Module");
         if (validate && failed(mlir::verify(theModule)))
         {
             LLVM_DEBUG(llvm::dbgs() << "\n!! broken module: \n" << theModule << "\n";);
@@ -724,6 +764,22 @@ class MLIRGenImpl
 
         builder.create<mlir_ts::GlobalConstructorOp>(location, mlir::FlatSymbolRefAttr::get(builder.getContext(), fullInitGlobalFuncName));
 
+        // binary manifest lets us register declarations without re-parsing TypeScript source of library
+        auto addrOfManifest = dynLib.getAddressOfSymbol(SHARED_LIB_DECLARATIONS_MANIFEST);
+        auto addrOfManifestSize = dynLib.getAddressOfSymbol(SHARED_LIB_DECLARATIONS_MANIFEST_SIZE);
+        if (addrOfManifest && addrOfManifestSize)
+        {
+            auto dataPtr = *(const char**)addrOfManifest;
+            auto dataSize = *(const uint32_t*)addrOfManifestSize;
+            auto result = mlirGenImportDeclarationManifest(location, dataPtr, dataSize, dynamic, genContext);
+            if (result.has_value())
+            {
+                return result.value();
+            }
+
+            LLVM_DEBUG(llvm::dbgs() << "\n!! Shared lib manifest can't be used, falling back to declarations text\n";);
+        }
+
         // TODO: for now, we have code in TS to load methods from DLL/Shared libs
         if (auto addrOfDeclText = dynLib.getAddressOfSymbol(SHARED_LIB_DECLARATIONS))
         {
@@ -754,6 +810,134 @@ class MLIRGenImpl
         return mlir::success();
     }    
 
+    // returns std::nullopt when manifest can't be decoded (unknown version or types), caller should use declarations text
+    std::optional<mlir::LogicalResult> mlirGenImportDeclarationManifest(mlir::Location location, const char *dataPtr, size_t dataSize, bool dynamic, const GenContext &genContext)
+    {
+        SmallVector<DeclarationManifestRecord> records;
+        DeclarationManifestReader reader(dataPtr, dataSize);
+        if (!reader.read(records))
+        {
+            return std::nullopt;
+        }
+
+        // decode all types first, we should not register anything if we need to fall back to text
+        SmallVector<mlir::Type> types;
+        SmallVector<mlir::DictionaryAttr> values;
+        std::string sourceText;
+        for (auto &record : records)
+        {
+            mlir::Type type;
+            mlir::DictionaryAttr value;
+            switch (record.kind)
+            {
+            case DeclarationManifestKind::Function:
+            case DeclarationManifestKind::TypeAlias:
+                type = DeclarationManifestReader::parseType(builder.getContext(), record.payload);
+                if (!type)
+                {
+                    return std::nullopt;
+                }
+
+                break;
+            case DeclarationManifestKind::Enum:
+                type = DeclarationManifestReader::parseType(builder.getContext(), record.payload);
+                value = DeclarationManifestReader::parseDictionary(builder.getContext(), record.extra);
+                if (!type || !value)
+                {
+                    return std::nullopt;
+                }
+
+                break;
+            case DeclarationManifestKind::Source:
+                sourceText += record.payload;
+                break;
+            default:
+                return std::nullopt;
+            }
+
+            types.push_back(type);
+            values.push_back(value);
+        }
+
+        LLVM_DEBUG(llvm::dbgs() << "\n!! Shared lib import (manifest): " << records.size() << " record(s)\n";);
+
+        // types & enums first as declarations in text can refer to them
+        for (auto [index, record] : llvm::enumerate(records))
+        {
+            auto namePtr = StringRef(record.name).copy(stringAllocator);
+            if (record.kind == DeclarationManifestKind::TypeAlias)
+            {
+                getTypeAliasMap().insert({namePtr, types[index]});
+            }
+            else if (record.kind == DeclarationManifestKind::Enum)
+            {
+                getEnumsMap().insert({namePtr, std::make_pair(types[index], values[index])});
+            }
+        }
+
+        if (!sourceText.empty())
+        {
+            if (dynamic)
+            {
+                // TODO: use option variable instead of "this hack"
+                sourceText = MLIRHelper::replaceAll(sourceText.c_str(), "@dllimport", "@dllimport('.')");
+            }
+
+            LLVM_DEBUG(llvm::dbgs() << "\n!! Shared lib import (manifest source): \n" << sourceText << "\n";);
+
+            if (mlir::failed(parsePartialStatements(ConvertUTF8toWide(sourceText), genContext, false)))
+            {
+                return mlir::failure();
+            }
+        }
+
+        for (auto [index, record] : llvm::enumerate(records))
+        {
+            if (record.kind != DeclarationManifestKind::Function)
+            {
+                continue;
+            }
+
+            auto funcType = types[index].dyn_cast<mlir_ts::FunctionType>();
+            if (!funcType)
+            {
+                emitError(location, "invalid function type in shared library manifest: ") << record.name;
+                return mlir::failure();
+            }
+
+            auto namePtr = StringRef(record.name).copy(stringAllocator);
+            auto fullName = getFullNamespaceName(namePtr);
+
+            SmallVector<mlir::NamedAttribute> attrs;
+            attrs.push_back({mlir::StringAttr::get(builder.getContext(), "import"), mlir::UnitAttr::get(builder.getContext())});
+            auto funcOp = mlir_ts::FuncOp::create(location, fullName, funcType, attrs);
+
+            if (dynamic)
+            {
+                if (mlir::failed(mlirGenFunctionLikeDeclarationDynamicImport(location, funcOp, namePtr, genContext)))
+                {
+                    return mlir::failure();
+                }
+
+                continue;
+            }
+
+            funcOp.setPrivate();
+            if (!genContext.dummyRun)
+            {
+                theModule.push_back(funcOp);
+            }
+
+            getFunctionTypeMap().insert({fullName, funcType});
+            if (!getFunctionMap().count(namePtr))
+            {
+                getFunctionMap().insert({namePtr, funcOp});
+            }
+        }
+
+        return mlir::success();
+    }
+
     mlir::LogicalResult mlirGen(ImportDeclaration importDeclarationAST, const GenContext &genContext)
     {
         auto location = loc(importDeclarationAST);
@@ -2110,6 +2294,8 @@ class MLIRGenImpl
     std::tuple<mlir::LogicalResult, mlir_ts::FunctionType, std::string> instantiateSpecializedFunctionType(
         mlir::Location location, StringRef name, NodeArray<TypeNode> typeArguments, bool skipThisParam, const GenContext &genContext)
     {
+        llvm::TimeTraceScope timeScope("Instantiate Generic Function", name);
+
         auto functionGenericTypeInfo = getGenericFunctionInfoByFullName(name);
         if (functionGenericTypeInfo)
         {
@@ -2297,6 +2483,8 @@ class MLIRGenImpl
                                                                                bool allowNamedGenerics = false)
     {
         auto fullNameGenericClassTypeName = genericClassType.getName().getValue();
+        llvm::TimeTraceScope timeScope("Instantiate Generic Class", fullNameGenericClassTypeName);
+
         auto genericClassInfo = getGenericClassInfoByFullName(fullNameGenericClassTypeName);
         if (genericClassInfo)
         {
@@ -2345,6 +2533,8 @@ class MLIRGenImpl
         const GenContext &genContext, bool allowNamedGenerics = false)
     {
         auto fullNameGenericInterfaceTypeName = genericInterfaceType.getName().getValue();
+        llvm::TimeTraceScope timeScope("Instantiate Generic Interface", fullNameGenericInterfaceTypeName);
+
         auto genericInterfaceInfo = getGenericInterfaceInfoByFullName(fullNameGenericInterfaceTypeName);
         if (genericInterfaceInfo)
         {
@@ -3615,7 +3805,7 @@ class MLIRGenImpl
             varClass.isExport = getExportModifier(variableDeclarationListAST->parent);
             if (varClass.isExport)
             {
-                addDeclarationToExport(variableDeclarationListAST->parent, "@dllimport\n");
+                addVariableDeclarationToExport(variableDeclarationListAST);
             }
         }
 
@@ -4139,8 +4329,7 @@ class MLIRGenImpl
             if (functionLikeDeclarationBaseAST == SyntaxKind::FunctionDeclaration
                 || functionLikeDeclarationBaseAST == SyntaxKind::ArrowFunction)
             {
-                //addDeclarationToExport(funcProto->getName(), funcType, genContext);
-                addFunctionDeclarationToExport(functionLikeDeclarationBaseAST);
+                addFunctionDeclarationToExport(functionLikeDeclarationBaseAST, funcProto, funcType);
             }
         }
 
@@ -4698,6 +4887,8 @@ class MLIRGenImpl
             return {result, funcOp, funcProto->getName().str(), false};
         }
 
+        llvm::TimeTraceScope timeScope(genContext.dummyRun ? "MLIRGen Function (discover)" : "MLIRGen Function", funcProto->getName());
+
         auto funcGenContext = GenContext(genContext);
         funcGenContext.clearScopeVars();
         funcGenContext.funcOp = funcOp;
@@ -6749,24 +6940,440 @@ class MLIRGenImpl
                 defaultBlock = caseBodyBlock;
                 if (!isDefaultAsFirstCase && previousConditionOrFirstBranchOp)
                 {
-                    setPreviousCondOrJumpOp(previousConditionOrFirstBranchOp, caseBodyBlock);
+                    setPreviousCondOrJumpOp(previousConditionOrFirstBranchOp, caseBodyBlock);
+                }
+            }
+
+            // set pending BranchOps
+            for (auto pendingBranch : pendingBranches)
+            {
+                pendingBranch.setDest(caseBodyBlock);
+            }
+
+            pendingBranches.clear();
+
+            for (auto pendingCondition : pendingConditions)
+            {
+                pendingCondition.setSuccessor(caseBodyBlock, trueIndex);
+            }
+
+            pendingConditions.clear();
+
+            // process body case
+            if (genContext.generatedStatements.size() > 0)
+            {
+                // auto generated code
+                for (auto &statement : genContext.generatedStatements)
+                {
+                    if (failed(mlirGen(statement, genContext)))
+                    {
+                        return mlir::failure();
+                    }
+                }
+
+                // clean up
+                const_cast<GenContext &>(genContext).generatedStatements.clear();
+            }
+
+            auto hasBreak = false;
+            for (auto statement : statements)
+            {
+                if ((SyntaxKind)statement == SyntaxKind::BreakStatement)
+                {
+                    hasBreak = true;
+                    break;
+                }
+
+                if (failed(mlirGen(statement, genContext)))
+                {
+                    return mlir::failure();
+                }
+            }
+
+            // exit;
+            auto branchOp = builder.create<mlir::cf::BranchOp>(location, mergeBlock);
+            if (!hasBreak && !isDefaultCase)
+            {
+                pendingBranches.push_back(branchOp);
+            }
+        }
+
+        return mlir::success();
+    }
+
+    bool isSwitchCaseConstExpression(Expression caseExpr, const GenContext &genContext)
+    {
+        auto expr = stripParentheses(caseExpr);
+        switch ((SyntaxKind)expr)
+        {
+        case SyntaxKind::NumericLiteral:
+        case SyntaxKind::StringLiteral:
+        case SyntaxKind::NoSubstitutionTemplateLiteral:
+            return true;
+        case SyntaxKind::PrefixUnaryExpression:
+            {
+                auto prefixUnaryExpression = expr.as<PrefixUnaryExpression>();
+                auto opCode = prefixUnaryExpression->_operator;
+                return (opCode == SyntaxKind::MinusToken || opCode == SyntaxKind::PlusToken)
+                    && (SyntaxKind)stripParentheses(prefixUnaryExpression->operand) == SyntaxKind::NumericLiteral;
+            }
+        case SyntaxKind::PropertyAccessExpression:
+            {
+                auto objectType = evaluate(expr.as<PropertyAccessExpression>()->expression, genContext);
+                return objectType && objectType.isa<mlir_ts::EnumType>();
+            }
+        case SyntaxKind::Identifier:
+            {
+                auto identifierType = evaluate(expr, genContext);
+                return identifierType && identifierType.isa<mlir_ts::LiteralType>();
+            }
+        default:
+            return false;
+        }
+    }
+
+    enum SwitchStringKeyPart
+    {
+        KeyLength = 1,
+        KeyFirstChar = 2,
+        KeyMiddleChar = 4,
+        KeyLastChar = 8
+    };
+
+    // must produce the same value as mlirGenSwitchStringKey at runtime
+    uint32_t getSwitchStringKey(StringRef value, int keyParts)
+    {
+        // strings are null-terminated at runtime
+        value = value.take_until([](char c) { return c == '\0'; });
+        auto length = value.size();
+        auto charAt = [&](size_t index) -> uint32_t { return index < length ? (uint8_t)value[index] : 0; };
+
+        uint32_t key = 0;
+        if (keyParts & KeyLength)
+        {
+            key |= (length & 0xff) << 24;
+        }
+
+        if (keyParts & KeyFirstChar)
+        {
+            key |= charAt(0) << 16;
+        }
+
+        if (keyParts & KeyMiddleChar)
+        {
+            key |= charAt(length >> 1) << 8;
+        }
+
+        if (keyParts & KeyLastChar)
+        {
+            key |= charAt(length > 0 ? length - 1 : 0);
+        }
+
+        return key;
+    }
+
+    mlir::Value mlirGenSwitchStringKey(mlir::Location location, mlir::Value stringValue, int keyParts)
+    {
+        auto i32Type = builder.getI32Type();
+        auto constI32 = [&](int32_t value) -> mlir::Value {
+            return builder.create<mlir_ts::ConstantOp>(location, i32Type, builder.getI32IntegerAttr(value));
+        };
+        auto binOp = [&](SyntaxKind opCode, mlir::Value left, mlir::Value right) -> mlir::Value {
+            return builder.create<mlir_ts::ArithmeticBinaryOp>(location, i32Type, builder.getI32IntegerAttr((int)opCode),
+                                                               left, right);
+        };
+        // reading at length returns terminating '\0'
+        auto charAt = [&](mlir::Value index) -> mlir::Value {
+            auto charRef =
+                builder.create<mlir_ts::ElementRefOp>(location, mlir_ts::RefType::get(getCharType()), stringValue, index);
+            auto charValue = builder.create<mlir_ts::LoadOp>(location, getCharType(), charRef);
+            return builder.create<mlir_ts::CastOp>(location, i32Type, charValue);
+        };
+
+        mlir::Value length;
+        if (keyParts & (KeyLength | KeyMiddleChar | KeyLastChar))
+        {
+            length = builder.create<mlir_ts::StringLengthOp>(location, i32Type, stringValue);
+        }
+
+        mlir::Value key = constI32(0);
+        if (keyParts & KeyLength)
+        {
+            auto lengthByte = binOp(SyntaxKind::AmpersandToken, length, constI32(0xff));
+            key = binOp(SyntaxKind::BarToken, key, binOp(SyntaxKind::LessThanLessThanToken, lengthByte, constI32(24)));
+        }
+
+        if (keyParts & KeyFirstChar)
+        {
+            key = binOp(SyntaxKind::BarToken, key,
+                        binOp(SyntaxKind::LessThanLessThanToken, charAt(constI32(0)), constI32(16)));
+        }
+
+        if (keyParts & KeyMiddleChar)
+        {
+            auto middleIndex = binOp(SyntaxKind::GreaterThanGreaterThanToken, length, constI32(1));
+            key = binOp(SyntaxKind::BarToken, key,
+                        binOp(SyntaxKind::LessThanLessThanToken, charAt(middleIndex), constI32(8)));
+        }
+
+        if (keyParts & KeyLastChar)
+        {
+            // length - 1, or 0 for empty string
+            auto lengthMinusOne = binOp(SyntaxKind::MinusToken, length, constI32(1));
+            auto isEmpty = binOp(SyntaxKind::GreaterThanGreaterThanToken, lengthMinusOne, constI32(31));
+            auto lastIndex = binOp(SyntaxKind::MinusToken, lengthMinusOne, isEmpty);
+            key = binOp(SyntaxKind::BarToken, key, charAt(lastIndex));
+        }
+
+        return key;
+    }
+
+    // switch with constant cases: jump to case body by cf.switch (integers) or by hash of string and one compare
+    // instead of checking cases one by one
+    mlir::LogicalResult mlirGenSwitchDispatch(mlir::Location location, mlir::Value switchValue,
+                                              NodeArray<ts::CaseOrDefaultClause> &clauses, mlir::Block *mergeBlock,
+                                              std::function<void(Expression, mlir::Value)> extraCode,
+                                              bool &dispatched, const GenContext &genContext)
+    {
+        dispatched = false;
+
+        auto casesCount = 0;
+        for (auto clause : clauses)
+        {
+            if (SyntaxKind::CaseClause == (SyntaxKind)clause)
+            {
+                if (!isSwitchCaseConstExpression(clause.as<CaseClause>()->expression, genContext))
+                {
+                    return mlir::success();
+                }
+
+                casesCount++;
+            }
+        }
+
+        if (casesCount < SWITCH_DISPATCH_MIN_CASES)
+        {
+            return mlir::success();
+        }
+
+        mlir::OpBuilder::InsertionGuard guard(builder);
+
+        // values of cases, first block is entry of switch
+        auto dispatchBlock = builder.createBlock(mergeBlock);
+
+        mlir::Type caseType;
+        SmallVector<mlir::Value> caseValues;
+        SmallVector<mlir::Attribute> caseAttrs;
+        auto isDispatchable = true;
+        for (auto clause : clauses)
+        {
+            if (SyntaxKind::CaseClause != (SyntaxKind)clause)
+            {
+                caseValues.push_back(mlir::Value());
+                caseAttrs.push_back(mlir::Attribute());
+                continue;
+            }
+
+            auto result = mlirGen(clause.as<CaseClause>()->expression, genContext);
+            EXIT_IF_FAILED_OR_NO_VALUE(result)
+            auto caseValue = V(result);
+
+            auto constantOp = caseValue.getDefiningOp<mlir_ts::ConstantOp>();
+            auto actualCaseType = mth.stripLiteralType(caseValue.getType());
+            if (!constantOp || (caseType && caseType != actualCaseType))
+            {
+                isDispatchable = false;
+                break;
+            }
+
+            caseType = actualCaseType;
+            caseValues.push_back(caseValue);
+            caseAttrs.push_back(constantOp.getValue());
+        }
+
+        auto isInteger = isDispatchable && caseType.isa<mlir::IntegerType>() && !caseType.isInteger(1)
+                         && llvm::all_of(caseAttrs, [](auto attr) { return !attr || attr.template isa<mlir::IntegerAttr>(); });
+        auto isString = isDispatchable && caseType.isa<mlir_ts::StringType>() && casesCount >= SWITCH_HASH_DISPATCH_MIN_CASES
+                        && llvm::all_of(caseAttrs, [](auto attr) { return !attr || attr.template isa<mlir::StringAttr>(); });
+        if (!isInteger && !isString)
+        {
+            // back to sequence of compares
+            dispatchBlock->erase();
+            return mlir::success();
+        }
+
+        dispatched = true;
+
+        auto switchValueEffective = switchValue;
+        if (switchValue.getType() != caseType)
+        {
+            CAST(switchValueEffective, location, caseType, switchValue, genContext);
+        }
+
+        // bodies of cases in order of declaration to keep fall through
+        SmallVector<mlir::Block *> bodyBlocks;
+        mlir::Block *defaultTarget = mergeBlock;
+        for (auto clause : clauses)
+        {
+            auto caseBodyBlock = builder.createBlock(mergeBlock);
+            bodyBlocks.push_back(caseBodyBlock);
+            if (SyntaxKind::DefaultClause == (SyntaxKind)clause)
+            {
+                defaultTarget = caseBodyBlock;
+            }
+        }
+
+        // dispatch
+        builder.setInsertionPointToEnd(dispatchBlock);
+        if (isInteger)
+        {
+            auto width = caseType.getIntOrFloatBitWidth();
+            SmallVector<llvm::APInt> caseIntValues;
+            SmallVector<mlir::Block *> caseDestinations;
+            for (size_t index = 0; index < caseAttrs.size(); index++)
+            {
+                auto attr = caseAttrs[index];
+                if (!attr)
+                {
+                    continue;
+                }
+
+                auto value = attr.cast<mlir::IntegerAttr>().getValue().sextOrTrunc(width);
+                // first case wins
+                if (llvm::is_contained(caseIntValues, value))
+                {
+                    continue;
+                }
+
+                caseIntValues.push_back(value);
+                caseDestinations.push_back(bodyBlocks[index]);
+            }
+
+            builder.create<mlir::cf::SwitchOp>(location, switchValueEffective, defaultTarget, mlir::ValueRange{},
+                                               caseIntValues, caseDestinations,
+                                               SmallVector<mlir::ValueRange>(caseDestinations.size(), mlir::ValueRange{}));
+        }
+        else
+        {
+            // choose cheapest key which separates all cases, first char does not need length of string
+            int keyPartsVariants[] = {KeyFirstChar, KeyLength, KeyLength | KeyFirstChar, KeyFirstChar | KeyLastChar,
+                                      KeyLength | KeyFirstChar | KeyLastChar,
+                                      KeyLength | KeyFirstChar | KeyMiddleChar | KeyLastChar};
+            auto keyParts = KeyLength | KeyFirstChar | KeyMiddleChar | KeyLastChar;
+            for (auto keyPartsVariant : keyPartsVariants)
+            {
+                llvm::DenseMap<uint32_t, mlir::Attribute> keys;
+                auto isPerfect = llvm::all_of(caseAttrs, [&](mlir::Attribute attr) {
+                    if (!attr)
+                    {
+                        return true;
+                    }
+
+                    auto inserted = keys.try_emplace(getSwitchStringKey(attr.cast<mlir::StringAttr>().getValue(), keyPartsVariant), attr);
+                    return inserted.second || inserted.first->second == attr;
+                });
+
+                if (isPerfect)
+                {
+                    keyParts = keyPartsVariant;
+                    break;
+                }
+            }
+
+            // buckets of cases with the same key in order of declaration
+            SmallVector<uint32_t> keys;
+            llvm::DenseMap<uint32_t, SmallVector<size_t>> buckets;
+            for (size_t index = 0; index < caseAttrs.size(); index++)
+            {
+                auto attr = caseAttrs[index];
+                if (!attr)
+                {
+                    continue;
+                }
+
+                auto key = getSwitchStringKey(attr.cast<mlir::StringAttr>().getValue(), keyParts);
+                if (!buckets.count(key))
+                {
+                    keys.push_back(key);
                 }
+
+                buckets[key].push_back(index);
             }
 
-            // set pending BranchOps
-            for (auto pendingBranch : pendingBranches)
+            // null is equal to none of cases
+            auto hashBlock = builder.createBlock(bodyBlocks.front());
+            builder.setInsertionPointToEnd(dispatchBlock);
+
+            CAST_A(opaqueSwitchValue, location, getOpaqueType(), switchValueEffective, genContext);
+            auto nullVal = builder.create<mlir_ts::NullOp>(location, getNullType());
+            auto compareToNull = builder.create<mlir_ts::LogicalBinaryOp>(
+                location, getBooleanType(), builder.getI32IntegerAttr((int)SyntaxKind::EqualsEqualsEqualsToken),
+                opaqueSwitchValue, nullVal);
+            CAST_A(isNull, location, builder.getI1Type(), compareToNull, genContext);
+            builder.create<mlir::cf::CondBranchOp>(location, isNull, defaultTarget, mlir::ValueRange{}, hashBlock,
+                                                   mlir::ValueRange{});
+
+            // compare with cases of bucket
+            SmallVector<llvm::APInt> caseIntValues;
+            SmallVector<mlir::Block *> caseDestinations;
+            for (auto key : keys)
             {
-                pendingBranch.setDest(caseBodyBlock);
+                mlir::Block *previousCompareBlock = nullptr;
+                for (auto index : buckets[key])
+                {
+                    auto compareBlock = builder.createBlock(bodyBlocks.front());
+                    if (!previousCompareBlock)
+                    {
+                        caseIntValues.push_back(llvm::APInt(32, key));
+                        caseDestinations.push_back(compareBlock);
+                    }
+                    else
+                    {
+                        previousCompareBlock->getTerminator()->setSuccessor(compareBlock, 1);
+                    }
+
+                    auto condition = builder.create<mlir_ts::LogicalBinaryOp>(
+                        location, getBooleanType(), builder.getI32IntegerAttr((int)SyntaxKind::EqualsEqualsToken),
+                        switchValueEffective, caseValues[index]);
+                    CAST_A(conditionI1, location, builder.getI1Type(), condition, genContext);
+                    builder.create<mlir::cf::CondBranchOp>(location, conditionI1, bodyBlocks[index], mlir::ValueRange{},
+                                                           defaultTarget, mlir::ValueRange{});
+
+                    previousCompareBlock = compareBlock;
+                }
             }
 
-            pendingBranches.clear();
+            builder.setInsertionPointToEnd(hashBlock);
+            auto key = mlirGenSwitchStringKey(location, switchValueEffective, keyParts);
+            builder.create<mlir::cf::SwitchOp>(location, key, defaultTarget, mlir::ValueRange{}, caseIntValues,
+                                               caseDestinations,
+                                               SmallVector<mlir::ValueRange>(caseDestinations.size(), mlir::ValueRange{}));
+        }
 
-            for (auto pendingCondition : pendingConditions)
+        // bodies
+        for (size_t index = 0; index < clauses.size(); index++)
+        {
+            SymbolTableScopeT safeCastVarScope(symbolTable);
+
+            auto clause = clauses[index];
+
+            builder.setInsertionPointToStart(bodyBlocks[index]);
+
+            if (SyntaxKind::CaseClause == (SyntaxKind)clause)
             {
-                pendingCondition.setSuccessor(caseBodyBlock, trueIndex);
+                extraCode(clause.as<CaseClause>()->expression, caseValues[index]);
             }
 
-            pendingConditions.clear();
+            auto statements = clause->statements;
+            // inline block
+            if (statements.size() == 1)
+            {
+                auto firstStatement = statements.front();
+                if ((SyntaxKind)firstStatement == SyntaxKind::Block)
+                {
+                    statements = statements.front().as<Block>()->statements;
+                }
+            }
 
             // process body case
             if (genContext.generatedStatements.size() > 0)
@@ -6799,12 +7406,9 @@ class MLIRGenImpl
                 }
             }
 
-            // exit;
-            auto branchOp = builder.create<mlir::cf::BranchOp>(location, mergeBlock);
-            if (!hasBreak && !isDefaultCase)
-            {
-                pendingBranches.push_back(branchOp);
-            }
+            // exit or fall through to next case
+            auto isLast = index + 1 == bodyBlocks.size();
+            builder.create<mlir::cf::BranchOp>(location, hasBreak || isLast ? mergeBlock : bodyBlocks[index + 1]);
         }
 
         return mlir::success();
@@ -6865,6 +7469,19 @@ class MLIRGenImpl
             safeCastLogic = [&](Expression caseExpr, mlir::Value constVal) {};
         }
 
+        auto dispatched = false;
+        if (mlir::failed(mlirGenSwitchDispatch(location, switchValue, clauses, mergeBlock, safeCastLogic, dispatched,
+                                               switchGenContext)))
+        {
+            return mlir::failure();
+        }
+
+        if (dispatched)
+        {
+            LLVM_DEBUG(llvm::dbgs() << "\n!! SWITCH (dispatch): " << switchOp << "\n");
+            return mlir::success();
+        }
+
         // process without default
         for (int index = 0; index < clauses.size(); index++)
         {
@@ -7577,8 +8194,21 @@ class MLIRGenImpl
         if (auto classType = type.dyn_cast<mlir_ts::ClassType>())
         {
             auto classInfo = getClassInfoByFullName(classType.getName().getValue());
-            if (resultType.isa<mlir_ts::ClassType>())
+            if (auto resultClassType = resultType.dyn_cast<mlir_ts::ClassType>())
             {
+                // static class is the class or derived from it: only null is not instance, no need to call .instanceOf
+                auto resultClassInfo = getClassInfoByFullName(resultClassType.getName().getValue());
+                SmallVector<StringRef> classNames;
+                if (resultClassInfo && resultClassInfo->getBasesWithRoot(classNames) &&
+                    llvm::is_contained(classNames, classType.getName().getValue()))
+                {
+                    CAST_A(opaqueValue, location, getOpaqueType(), result, genContext);
+                    auto nullVal = builder.create<mlir_ts::NullOp>(location, getNullType());
+                    return V(builder.create<mlir_ts::LogicalBinaryOp>(
+                        location, getBooleanType(),
+                        builder.getI32IntegerAttr((int)SyntaxKind::ExclamationEqualsEqualsToken), opaqueValue, nullVal));
+                }
+
                 NodeFactory nf(NodeFactoryFlags::None);
                 NodeArray<Expression> argumentsArray;
                 argumentsArray.push_back(nf.createPropertyAccessExpression(binaryExpressionAST->right, nf.createIdentifier(S(RTTI_NAME))));
@@ -9349,6 +9979,12 @@ class MLIRGenImpl
     {
         auto location = loc(callExpression);
 
+        SmallVector<CallExpression> arrayMethodChain;
+        if (isInlinableArrayMethodChain(callExpression, arrayMethodChain, genContext))
+        {
+            return mlirGenInlinedArrayMethodChain(location, arrayMethodChain, genContext);
+        }
+
         auto callExpr = callExpression->expression.as<Expression>();
 
         auto result = mlirGen(callExpr, genContext);
@@ -9401,6 +10037,318 @@ class MLIRGenImpl
         return mlirGenCallExpression(location, funcResult, callExpression->typeArguments, operands, genContext);
     }
 
+    // returns name of array method if call is "<receiver>.<method>(...)" without optional chaining
+    std::string getArrayMethodCallName(CallExpression callExpression)
+    {
+        if (callExpression->questionDotToken || callExpression->expression != SyntaxKind::PropertyAccessExpression)
+        {
+            return std::string();
+        }
+
+        auto propertyAccessExpression = callExpression->expression.as<PropertyAccessExpression>();
+        if (propertyAccessExpression->questionDotToken || propertyAccessExpression->name != SyntaxKind::Identifier)
+        {
+            return std::string();
+        }
+
+        return MLIRHelper::getName(propertyAccessExpression->name.as<Identifier>());
+    }
+
+    // lambda can be inlined if it is not async arrow function with simple parameters and it does not have "return"
+    // statements (allowed only for forEach as result is ignored)
+    bool isInlinableArrayMethodLambda(Node node, size_t maxParams, bool allowBlockBody)
+    {
+        if (node != SyntaxKind::ArrowFunction)
+        {
+            return false;
+        }
+
+        auto arrowFunction = node.as<ArrowFunction>();
+        if (!arrowFunction->modifiers.empty() || !arrowFunction->typeParameters.empty() ||
+            arrowFunction->parameters.size() > maxParams)
+        {
+            return false;
+        }
+
+        for (auto param : arrowFunction->parameters)
+        {
+            if (param->name != SyntaxKind::Identifier || param->dotDotDotToken || param->questionToken ||
+                param->initializer)
+            {
+                return false;
+            }
+        }
+
+        if (arrowFunction->body == SyntaxKind::Block)
+        {
+            if (!allowBlockBody)
+            {
+                return false;
+            }
+
+            auto hasReturn = false;
+            FilterVisitorSkipFuncsAST<ReturnStatement> visitor(SyntaxKind::ReturnStatement,
+                                                               [&](auto) { hasReturn = true; });
+            visitor.visit(arrowFunction->body);
+            return !hasReturn;
+        }
+
+        return true;
+    }
+
+    // chain "arr.map(...).filter(...).reduce(...)" where all callbacks are inlinable lambdas, terminal method is
+    // forEach, every, some or reduce (map and filter alone produce iterators and are not inlined)
+    bool isInlinableArrayMethodChain(CallExpression callExpression, SmallVector<CallExpression> &chain,
+                                     const GenContext &genContext)
+    {
+        auto terminalName = getArrayMethodCallName(callExpression);
+        if (terminalName == "forEach" || terminalName == "every" || terminalName == "some")
+        {
+            if (callExpression->arguments.size() != 1 ||
+                !isInlinableArrayMethodLambda(callExpression->arguments[0], 1, terminalName == "forEach"))
+            {
+                return false;
+            }
+        }
+        else if (terminalName == "reduce")
+        {
+            if (callExpression->arguments.size() != 2 ||
+                !isInlinableArrayMethodLambda(callExpression->arguments[0], 2, false))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            return false;
+        }
+
+        chain.push_back(callExpression);
+
+        auto receiver = callExpression->expression.as<PropertyAccessExpression>()->expression.as<Expression>();
+        while (receiver == SyntaxKind::CallExpression)
+        {
+            auto stageCall = receiver.as<CallExpression>();
+            auto stageName = getArrayMethodCallName(stageCall);
+            if ((stageName != "map" && stageName != "filter") || stageCall->arguments.size() != 1 ||
+                !isInlinableArrayMethodLambda(stageCall->arguments[0], 1, false))
+            {
+                break;
+            }
+
+            chain.insert(chain.begin(), stageCall);
+            receiver = stageCall->expression.as<PropertyAccessExpression>()->expression.as<Expression>();
+        }
+
+        // stages are nested into each other, so parameter of previous stage must not hide outer name used in next one
+        llvm::StringSet<> visibleParams;
+        for (auto stageCall : chain)
+        {
+            auto arrowFunction = stageCall->arguments[0].as<ArrowFunction>();
+
+            llvm::StringSet<> ownParams;
+            for (auto param : arrowFunction->parameters)
+            {
+                ownParams.insert(MLIRHelper::getName(param->name.as<Identifier>()));
+            }
+
+            auto hidden = false;
+            auto checkIdentifier = [&](Identifier identifier) {
+                auto name = MLIRHelper::getName(identifier);
+                if (visibleParams.count(name) && !ownParams.count(name))
+                {
+                    hidden = true;
+                }
+            };
+
+            if (arrowFunction->body == SyntaxKind::Identifier)
+            {
+                checkIdentifier(arrowFunction->body.as<Identifier>());
+            }
+
+            FilterVisitorAST<Identifier> visitor(SyntaxKind::Identifier, checkIdentifier);
+            visitor.visit(arrowFunction->body);
+            if (hidden)
+            {
+                return false;
+            }
+
+            for (auto &param : ownParams)
+            {
+                visibleParams.insert(param.getKey());
+            }
+        }
+
+        auto receiverType = evaluate(receiver, genContext);
+        return receiverType && (receiverType.isa<mlir_ts::ArrayType>() || receiverType.isa<mlir_ts::ConstArrayType>());
+    }
+
+    ValueOrLogicalResult mlirGenInlinedArrayMethodChain(mlir::Location location, ArrayRef<CallExpression> chain,
+                                                        const GenContext &genContext)
+    {
+        SymbolTableScopeT varScope(symbolTable);
+
+        NodeFactory nf(NodeFactoryFlags::None);
+
+        auto terminalCall = chain.back();
+        auto terminalName = getArrayMethodCallName(terminalCall);
+        auto receiver = chain.front()->expression.as<PropertyAccessExpression>()->expression.as<Expression>();
+
+        auto result = mlirGen(receiver, genContext);
+        EXIT_IF_FAILED_OR_NO_VALUE(result)
+        auto arraySrc = V(result);
+
+        auto srcArrayVarDecl = std::make_shared<VariableDeclarationDOM>(".src_array", arraySrc.getType(), location);
+        DECLARE(srcArrayVarDecl, arraySrc);
+
+        auto _src_array_ident = nf.createIdentifier(S(".src_array"));
+        auto _result_ident = nf.createIdentifier(S(".r"));
+
+        // declares lambda parameter as local variable initialized by given value
+        auto declareParam = [&](ArrowFunction arrowFunction, size_t index, Expression value,
+                                NodeArray<Statement> &statements) {
+            if (index >= arrowFunction->parameters.size())
+            {
+                return;
+            }
+
+            auto param = arrowFunction->parameters[index];
+            NodeArray<VariableDeclaration> declarations;
+            declarations.push_back(
+                nf.createVariableDeclaration(param->name.as<Identifier>(), undefined, param->type, value));
+            statements.push_back(
+                nf.createVariableStatement(undefined, nf.createVariableDeclarationList(declarations, NodeFlags::Let)));
+        };
+
+        auto lambdaOf = [&](CallExpression call) { return call->arguments[0].as<ArrowFunction>(); };
+
+        // result variable of terminal method
+        if (terminalName != "forEach")
+        {
+            Expression initValue;
+            TypeNode initType;
+            if (terminalName == "reduce")
+            {
+                initValue = terminalCall->arguments[1];
+                auto reduceLambda = lambdaOf(terminalCall);
+                if (!reduceLambda->parameters.empty())
+                {
+                    initType = reduceLambda->parameters[0]->type;
+                }
+            }
+            else
+            {
+                initValue = nf.createToken(terminalName == "every" ? SyntaxKind::TrueKeyword : SyntaxKind::FalseKeyword);
+            }
+
+            NodeArray<VariableDeclaration> declarations;
+            declarations.push_back(nf.createVariableDeclaration(_result_ident, undefined, initType, initValue));
+            auto declList = nf.createVariableDeclarationList(declarations, NodeFlags::Let);
+            if (mlir::failed(mlirGen(nf.createVariableStatement(undefined, declList), genContext)))
+            {
+                return mlir::failure();
+            }
+        }
+
+        // each stage is nested block of previous one, terminal method is the innermost
+        std::function<Statement(size_t, Expression)> buildStage;
+        buildStage = [&](size_t index, Expression current) -> Statement {
+            auto call = chain[index];
+            auto arrowFunction = lambdaOf(call);
+            auto body = arrowFunction->body;
+
+            NodeArray<Statement> statements;
+            if (index == chain.size() - 1)
+            {
+                if (terminalName == "forEach")
+                {
+                    declareParam(arrowFunction, 0, current, statements);
+                    if (body == SyntaxKind::Block)
+                    {
+                        for (auto statement : body.as<Block>()->statements)
+                        {
+                            statements.push_back(statement);
+                        }
+                    }
+                    else
+                    {
+                        statements.push_back(nf.createExpressionStatement(body.as<Expression>()));
+                    }
+                }
+                else if (terminalName == "reduce")
+                {
+                    declareParam(arrowFunction, 0, _result_ident, statements);
+                    declareParam(arrowFunction, 1, current, statements);
+                    statements.push_back(nf.createExpressionStatement(nf.createBinaryExpression(
+                        _result_ident, nf.createToken(SyntaxKind::EqualsToken), body.as<Expression>())));
+                }
+                else
+                {
+                    // every: stop on first false, some: stop on first true
+                    auto isEvery = terminalName == "every";
+                    declareParam(arrowFunction, 0, current, statements);
+
+                    NodeArray<Statement> stopStatements;
+                    stopStatements.push_back(nf.createExpressionStatement(nf.createBinaryExpression(
+                        _result_ident, nf.createToken(SyntaxKind::EqualsToken),
+                        nf.createToken(isEvery ? SyntaxKind::FalseKeyword : SyntaxKind::TrueKeyword))));
+                    stopStatements.push_back(nf.createBreakStatement());
+
+                    Expression condition = body.as<Expression>();
+                    if (isEvery)
+                    {
+                        condition = nf.createPrefixUnaryExpression(nf.createToken(SyntaxKind::ExclamationToken),
+                                                                   nf.createParenthesizedExpression(condition));
+                    }
+
+                    statements.push_back(
+                        nf.createIfStatement(condition, nf.createBlock(stopStatements, false), undefined));
+                }
+
+                return nf.createBlock(statements, false);
+            }
+
+            declareParam(arrowFunction, 0, current, statements);
+            if (getArrayMethodCallName(call) == "map")
+            {
+                auto _mapped_ident = nf.createIdentifier(stows(".m" + std::to_string(index)));
+                NodeArray<VariableDeclaration> declarations;
+                declarations.push_back(
+                    nf.createVariableDeclaration(_mapped_ident, undefined, undefined, body.as<Expression>()));
+                statements.push_back(nf.createVariableStatement(
+                    undefined, nf.createVariableDeclarationList(declarations, NodeFlags::Const)));
+                statements.push_back(buildStage(index + 1, _mapped_ident));
+            }
+            else
+            {
+                // filter
+                statements.push_back(
+                    nf.createIfStatement(body.as<Expression>(), buildStage(index + 1, current), undefined));
+            }
+
+            return nf.createBlock(statements, false);
+        };
+
+        auto _v_ident = nf.createIdentifier(S(".v"));
+
+        NodeArray<VariableDeclaration> declarations;
+        declarations.push_back(nf.createVariableDeclaration(_v_ident));
+        auto declList = nf.createVariableDeclarationList(declarations, NodeFlags::Const);
+
+        auto forOfStat = nf.createForOfStatement(undefined, declList, _src_array_ident, buildStage(0, _v_ident));
+        if (mlir::failed(mlirGen(forOfStat, genContext)))
+        {
+            return mlir::failure();
+        }
+
+        if (terminalName == "forEach")
+        {
+            return mlir::success();
+        }
+
+        return resolveIdentifier(location, ".r", genContext);
+    }
+
     mlir::LogicalResult mlirGenArrayForEach(mlir::Location location, ArrayRef<mlir::Value> operands,
                                             const GenContext &genContext)
     {
@@ -10565,41 +11513,11 @@ class MLIRGenImpl
         auto enabledGC = !compileOptions.disableGC;
         if (enabledGC && !stackAlloc)
         {
+            // type descriptor is initialized by global constructor
             auto typeDescrType = builder.getI64Type();
             auto typeDescGlobalName = getTypeDescriptorFieldName(classInfo);
             auto typeDescRef = resolveFullNameIdentifier(location, typeDescGlobalName, true, genContext);
-            auto typeDescCurrentValue = builder.create<mlir_ts::LoadOp>(location, typeDescrType, typeDescRef);
-
-            CAST_A(condVal, location, getBooleanType(), typeDescCurrentValue, genContext);
-
-            auto ifOp = builder.create<mlir_ts::IfOp>(
-                location, mlir::TypeRange{typeDescrType}, condVal,
-                [&](mlir::OpBuilder &opBuilder, mlir::Location loc) {
-                    builder.create<mlir_ts::ResultOp>(loc, mlir::ValueRange{typeDescCurrentValue});
-                },
-                [&](mlir::OpBuilder &opBuilder, mlir::Location loc) {
-                    // call typr bitmap
-                    auto fullClassStaticFieldName = getTypeBitmapMethodName(classInfo);
-
-                    auto funcType = getFunctionType({}, {typeDescrType}, false);
-
-                    auto funcSymbolOp = builder.create<mlir_ts::SymbolRefOp>(
-                        location, funcType,
-                        mlir::FlatSymbolRefAttr::get(builder.getContext(), fullClassStaticFieldName));
-
-                    auto callIndirectOp =
-                        builder.create<mlir_ts::CallIndirectOp>(
-                            MLIRHelper::getCallSiteLocation(funcSymbolOp->getLoc(), location),
-                            funcSymbolOp, mlir::ValueRange{});
-                    auto typeDescr = callIndirectOp.getResult(0);
-
-                    // save value
-                    builder.create<mlir_ts::StoreOp>(location, typeDescr, typeDescRef);
-
-                    builder.create<mlir_ts::ResultOp>(loc, mlir::ValueRange{typeDescr});
-                });
-
-            auto typeDescrValue = ifOp.getResult(0);
+            auto typeDescrValue = builder.create<mlir_ts::LoadOp>(location, typeDescrType, typeDescRef);
 
             assert(!stackAlloc);
             newOp = builder.create<mlir_ts::GCNewExplicitlyTypedOp>(location, classInfo->classType, typeDescrValue);
@@ -12361,7 +13279,7 @@ class MLIRGenImpl
         LLVM_DEBUG(llvm::dbgs() << "\n!! captured type: " << capturedType << "\n";);
 
         // add attributes to track which one sent by ref.
-        auto captured = builder.create<mlir_ts::CaptureOp>(location, capturedType, capturedValues);
+        auto captured = builder.create<mlir_ts::CaptureOp>(location, capturedType, capturedValues, mlir::BoolAttr());
         return V(captured);
     }
 
@@ -12881,7 +13799,7 @@ class MLIRGenImpl
 
                 if (hasExportModifier)
                 {
-                    addTypeDeclarationToExport(typeAliasDeclarationAST);
+                    addTypeDeclarationToExport(typeAliasDeclarationAST, namePtr, type);
                 }
             }
 
@@ -13046,7 +13964,7 @@ class MLIRGenImpl
 
         if (getExportModifier(enumDeclarationAST))
         {
-            addEnumDeclarationToExport(enumDeclarationAST);
+            addEnumDeclarationToExport(enumDeclarationAST, namePtr, storeType, getEnumsMap()[namePtr].second);
         }
 
         return mlir::success();
@@ -13230,8 +14148,8 @@ class MLIRGenImpl
         auto enabledGC = !compileOptions.disableGC;
         if (enabledGC && !newClassPtr->isStatic)
         {
-            mlirGenClassTypeBitmap(location, newClassPtr, classGenContext);
             mlirGenClassTypeDescriptorField(location, newClassPtr, classGenContext);
+            mlirGenClassTypeBitmap(location, newClassPtr, classGenContext);
         }
 #endif
 
@@ -14335,9 +15253,10 @@ genContext);
         // register global
         auto fullClassStaticFieldName = getTypeBitmapMethodName(newClassPtr);
 
-        auto funcType = getFunctionType({}, builder.getI64Type(), false);
+        // computes descriptor once before any other global constructor, so allocations do not check it
+        auto funcType = getFunctionType({}, {}, false);
 
-        mlirGenFunctionBody(
+        auto result = mlirGenFunctionBody(
             location, fullClassStaticFieldName, funcType,
             [&](const GenContext &genContext) {
                 auto bitmapValueType = mth.getTypeBitmapValueType();
@@ -14445,11 +15364,36 @@ genContext);
                 auto typeDescr = builder.create<mlir_ts::GCMakeDescriptorOp>(location, builder.getI64Type(), arrayValue,
                                                                              sizeOfTypeInBitmapTypes);
 
-                auto retVarInfo = symbolTable.lookup(RETURN_VARIABLE_NAME);
-                builder.create<mlir_ts::ReturnValOp>(location, typeDescr, retVarInfo.first);
+                // save value
+                auto typeDescRef = resolveFullNameIdentifier(location, getTypeDescriptorFieldName(newClassPtr), true, genContext);
+                builder.create<mlir_ts::StoreOp>(location, typeDescr, typeDescRef);
                 return ValueOrLogicalResult(mlir::success());
             },
             genContext);
+        if (mlir::failed(result))
+        {
+            return mlir::failure();
+        }
+
+        if (genContext.allowPartialResolve)
+        {
+            return mlir::success();
+        }
+
+        auto hasGlobalConstructor = llvm::any_of(theModule.getOps<mlir_ts::GlobalConstructorOp>(), [&](auto globalConstructorOp) {
+            return globalConstructorOp.getGlobalName() == fullClassStaticFieldName;
+        });
+        if (!hasGlobalConstructor)
+        {
+            mlir::OpBuilder::InsertionGuard insertGuard(builder);
+
+            MLIRCodeLogicHelper mclh(builder, location);
+            builder.setInsertionPointToStart(theModule.getBody());
+            mclh.seekLast(theModule.getBody());
+
+            builder.create<mlir_ts::GlobalConstructorOp>(
+                location, mlir::FlatSymbolRefAttr::get(builder.getContext(), fullClassStaticFieldName));
+        }
 
         return mlir::success();
     }
@@ -14491,25 +15435,23 @@ genContext);
                 //     nf.createPropertyAccessExpression(nf.createToken(SyntaxKind::ThisKeyword),
                 //                                       nf.createIdentifier(S(RTTI_NAME))));
 
-                // access .rtti via static field
-                auto fullClassStaticFieldName = concat(newClassPtr->fullName, RTTI_NAME);
-
-                auto cmpRttiToParam = nf.createBinaryExpression(
-                     nf.createIdentifier(S(INSTANCEOF_PARAM_NAME)), nf.createToken(SyntaxKind::EqualsEqualsToken),
-                     nf.createIdentifier(ConvertUTF8toWide(std::string(fullClassStaticFieldName))));
-
-                auto cmpLogic = cmpRttiToParam;
+                // compare with names of class and all its bases (names are values of .rtti), so check costs one
+                // virtual call: no calls of super.instanceOf up the chain. RTTI of class from the same module points
+                // to the same global as literal, so matching class is found by pointer compare, RTTI from other
+                // module (dynamic library) is compared by chars
+                SmallVector<StringRef> classNames;
+                newClassPtr->getBasesWithRoot(classNames);
 
-                if (!newClassPtr->baseClasses.empty())
+                Expression cmpLogic;
+                for (auto className : classNames)
                 {
-                    NodeArray<Expression> argumentsArray;
-                    argumentsArray.push_back(nf.createIdentifier(S(INSTANCEOF_PARAM_NAME)));
-                    cmpLogic =
-                        nf.createBinaryExpression(cmpRttiToParam, nf.createToken(SyntaxKind::BarBarToken),
-                                                  nf.createCallExpression(nf.createPropertyAccessExpression(
-                                                                              nf.createToken(SyntaxKind::SuperKeyword),
-                                                                              nf.createIdentifier(S(INSTANCEOF_NAME))),
-                                                                          undefined, argumentsArray));
+                    auto cmpRttiToParam = nf.createBinaryExpression(
+                        nf.createIdentifier(S(INSTANCEOF_PARAM_NAME)), nf.createToken(SyntaxKind::EqualsEqualsToken),
+                        nf.createStringLiteral(ConvertUTF8toWide(className.str())));
+
+                    cmpLogic = cmpLogic
+                        ? nf.createBinaryExpression(cmpLogic, nf.createToken(SyntaxKind::BarBarToken), cmpRttiToParam)
+                        : cmpRttiToParam;
                 }
 
                 auto returnStat = nf.createReturnStatement(cmpLogic);
@@ -20013,43 +20955,63 @@ genContext);
         return mlir::success();
     }
 
-    void addDeclarationToExport(ts::Node node, const char* prefix = nullptr)
+    std::string addDeclarationToExport(ts::Node node, const char* prefix = nullptr)
     {
-        Printer printer(declExports);
+        stringstream declExport;
+        Printer printer(declExport);
         printer.setDeclarationMode(true);
 
         if (prefix)
-            declExports << prefix;
+            declExport << prefix;
 
         printer.printNode(node);
-        declExports << ";\n";
+        declExport << ";\n";
+
+        declExports << declExport.str();
 
         LLVM_DEBUG(llvm::dbgs() << "\n!! added declaration to export: \n" << convertWideToUTF8(declExports.str()) << "\n";);      
+
+        return convertWideToUTF8(declExport.str());
     }
 
-    void addTypeDeclarationToExport(TypeAliasDeclaration typeAliasDeclaration)    
+    void addTypeDeclarationToExport(TypeAliasDeclaration typeAliasDeclaration, StringRef name, mlir::Type type)    
     {
         addDeclarationToExport(typeAliasDeclaration);
+        declManifest.addTypeAlias(name, type);
     }
 
     void addInterfaceDeclarationToExport(InterfaceDeclaration interfaceDeclaration)
     {
-        addDeclarationToExport(interfaceDeclaration);
+        declManifest.addSource(addDeclarationToExport(interfaceDeclaration));
     }
 
-    void addEnumDeclarationToExport(EnumDeclaration enumDeclatation)
+    void addEnumDeclarationToExport(EnumDeclaration enumDeclatation, StringRef name, mlir::Type storeType, mlir::DictionaryAttr values)
     {
         addDeclarationToExport(enumDeclatation);
+        declManifest.addEnum(name, storeType, values);
     }
 
-    void addFunctionDeclarationToExport(FunctionLikeDeclarationBase FunctionLikeDeclarationBase)
+    void addFunctionDeclarationToExport(FunctionLikeDeclarationBase functionLikeDeclarationBase, FunctionPrototypeDOM::TypePtr funcProto, mlir_ts::FunctionType funcType)
     {
-        addDeclarationToExport(FunctionLikeDeclarationBase, "@dllimport\n");
+        auto declText = addDeclarationToExport(functionLikeDeclarationBase, "@dllimport\n");
+        if (funcProto->getIsGeneric() || !funcType)
+        {
+            // generic functions are instantiated on import side, we need source for it
+            declManifest.addSource(declText);
+            return;
+        }
+
+        declManifest.addFunction(funcProto->getNameWithoutNamespace(), funcType);
     }
 
     void addClassDeclarationToExport(ClassLikeDeclaration classDeclatation)
     {
-        addDeclarationToExport(classDeclatation, "@dllimport\n");
+        declManifest.addSource(addDeclarationToExport(classDeclatation, "@dllimport\n"));
+    }
+
+    void addVariableDeclarationToExport(VariableDeclarationList variableDeclarationListAST)
+    {
+        declManifest.addSource(addDeclarationToExport(variableDeclarationListAST->parent, "@dllimport\n"));
     }
 
     auto getNamespace() -> StringRef
@@ -20586,6 +21548,7 @@ genContext);
     bool declarationMode;
 
     stringstream declExports;
+    DeclarationManifestWriter declManifest;
     stringstream exports;
 
 private:
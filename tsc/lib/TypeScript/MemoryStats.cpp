@@ -0,0 +1,186 @@
+#include "TypeScript/MemoryStats.h"
+
+#include "mlir/IR/Operation.h"
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/Process.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include <string>
+
+using namespace ::typescript;
+
+namespace
+{
+
+struct PhaseInfo
+{
+    std::string name;
+    int64_t bytes;
+    unsigned count;
+};
+
+struct ActiveScope
+{
+    size_t phaseIndex;
+    size_t startUsage;
+    int64_t childrenBytes;
+};
+
+struct MemoryStatsData
+{
+    bool enabled = false;
+    llvm::SmallVector<PhaseInfo> phases;
+    llvm::SmallVector<ActiveScope> scopes;
+    llvm::SmallVector<std::pair<std::string, size_t>> opCounts;
+
+    size_t getPhaseIndex(llvm::StringRef name)
+    {
+        for (auto [index, phase] : llvm::enumerate(phases))
+        {
+            if (phase.name == name)
+            {
+                return index;
+            }
+        }
+
+        phases.push_back({name.str(), 0, 0});
+        return phases.size() - 1;
+    }
+};
+
+MemoryStatsData &getData()
+{
+    static MemoryStatsData data;
+    return data;
+}
+
+size_t getPeakRSS()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return counters.PeakWorkingSetSize;
+    }
+
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+
+#ifdef __APPLE__
+    // bytes on macOS
+    return usage.ru_maxrss;
+#else
+    // kilobytes on Linux
+    return usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+void printSize(llvm::raw_ostream &os, int64_t bytes)
+{
+    os << llvm::format("%12.2f MB", bytes / (1024.0 * 1024.0));
+}
+
+} // namespace
+
+void MemoryStats::enable()
+{
+    getData().enabled = true;
+}
+
+bool MemoryStats::isEnabled()
+{
+    return getData().enabled;
+}
+
+void MemoryStats::recordOpCount(llvm::StringRef stage, mlir::Operation *op)
+{
+    if (!isEnabled())
+    {
+        return;
+    }
+
+    size_t count = 0;
+    op->walk([&](mlir::Operation *) { count++; });
+    getData().opCounts.push_back({stage.str(), count});
+}
+
+void MemoryStats::print(llvm::raw_ostream &os)
+{
+    auto &data = getData();
+
+    os << "===-------------------------------------------------------------------------===\n";
+    os << "                          Memory usage statistics\n";
+    os << "===-------------------------------------------------------------------------===\n";
+
+    os << "  Peak RSS: ";
+    printSize(os, getPeakRSS());
+    os << "\n\n";
+
+    os << "  Allocated (still in use at the end of phase):\n";
+    for (auto &phase : data.phases)
+    {
+        os << "    ";
+        printSize(os, phase.bytes);
+        os << "  " << phase.name;
+        if (phase.count > 1)
+        {
+            os << " (" << phase.count << " times)";
+        }
+
+        os << "\n";
+    }
+
+    os << "\n  Operations count:\n";
+    for (auto &opCount : data.opCounts)
+    {
+        os << llvm::format("    %12zu", opCount.second) << "  " << opCount.first << "\n";
+    }
+
+    os << "\n";
+}
+
+MemoryStatsScope::MemoryStatsScope(llvm::StringRef phase) : active(MemoryStats::isEnabled())
+{
+    if (!active)
+    {
+        return;
+    }
+
+    auto &data = getData();
+    data.scopes.push_back({data.getPhaseIndex(phase), llvm::sys::Process::GetMallocUsage(), 0});
+}
+
+MemoryStatsScope::~MemoryStatsScope()
+{
+    if (!active)
+    {
+        return;
+    }
+
+    auto &data = getData();
+    auto scope = data.scopes.pop_back_val();
+    auto totalBytes = static_cast<int64_t>(llvm::sys::Process::GetMallocUsage()) - static_cast<int64_t>(scope.startUsage);
+
+    auto &phase = data.phases[scope.phaseIndex];
+    phase.bytes += totalBytes - scope.childrenBytes;
+    phase.count++;
+
+    if (!data.scopes.empty())
+    {
+        data.scopes.back().childrenBytes += totalBytes;
+    }
+}
@@ -0,0 +1,233 @@
+#define DEBUG_TYPE "pass"
+
+#include "mlir/Pass/Pass.h"
+
+#include "TypeScript/Config.h"
+#include "TypeScript/TypeScriptDialect.h"
+#include "TypeScript/TypeScriptOps.h"
+#include "TypeScript/Passes.h"
+#include "TypeScript/ModulePass.h"
+
+#include "mlir/Dialect/Async/IR/Async.h"
+#include "mlir/Interfaces/LoopLikeInterface.h"
+
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "scanner_enums.h"
+
+namespace mlir_ts = mlir::typescript;
+
+namespace
+{
+
+// s = s + piece1 + piece2 ...: loaded value of s, the pieces and concatenations (last one is stored)
+struct Accumulation
+{
+    mlir_ts::LoadOp loadOp;
+    mlir_ts::StoreOp storeOp;
+    llvm::SmallVector<mlir::Value> pieces;
+    llvm::SmallVector<mlir_ts::ArithmeticBinaryOp> binOps;
+};
+
+// String variable which is accumulated in loop (s += piece, s = s + piece) is copied into growable buffer
+// (ts.StringBuilder) before the loop and every accumulation appends in place (ts.StringAppend), so n appends cost
+// O(n) in total instead of O(n^2) copies and garbage.
+// Buffer is modified in place, so no other value may point to it while loop is running. Variable is accepted when
+//  - it is local variable (not captured) declared outside of the loop
+//  - inside the loop it is used only by accumulations: load, concats with the loaded value as leftmost operand, store
+//    of the result back, where loaded value and intermediate results have no other uses
+//  - outside of the loop it is used only by loads and stores
+// Value of variable is normal string at any point, so nothing has to be done after the loop; when the loop starts
+// again, variable is copied into new buffer and values read after previous run stay untouched.
+class StringBuilderPass : public mlir::PassWrapper<StringBuilderPass, ModulePass>
+{
+  public:
+    MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(StringBuilderPass)
+
+    void runOnModule() override
+    {
+        auto m = getModule();
+
+        m.walk([&](mlir_ts::FuncOp funcOp) {
+            if (funcOp.isExternal())
+            {
+                return;
+            }
+
+            // generators and async functions can resume inside of loop
+            auto hasStates = funcOp.walk([](mlir_ts::SwitchStateOp) { return mlir::WalkResult::interrupt(); });
+            if (hasStates.wasInterrupted())
+            {
+                return;
+            }
+
+            // outer loops first, accumulations of outer loop are not visited again in inner loops
+            llvm::SmallVector<mlir::LoopLikeOpInterface> loops;
+            funcOp.walk<mlir::WalkOrder::PreOrder>([&](mlir::LoopLikeOpInterface loop) { loops.push_back(loop); });
+            for (auto loop : loops)
+            {
+                processLoop(loop);
+            }
+        });
+
+        LLVM_DEBUG(llvm::dbgs() << "\n!! AFTER STRING BUILDER DUMP: \n" << m << "\n";);
+    }
+
+  private:
+    void processLoop(mlir::LoopLikeOpInterface loop)
+    {
+        auto *loopOp = loop.getOperation();
+
+        // body can run in parallel
+        auto hasAsync = loopOp->walk([](mlir::async::ExecuteOp) { return mlir::WalkResult::interrupt(); });
+        if (hasAsync.wasInterrupted())
+        {
+            return;
+        }
+
+        llvm::MapVector<mlir::Operation *, llvm::SmallVector<Accumulation>> accumulations;
+        loopOp->walk([&](mlir_ts::StoreOp storeOp) {
+            Accumulation accumulation;
+            if (auto varOp = getAccumulatedVariable(storeOp, loopOp, accumulation))
+            {
+                accumulations[varOp].push_back(accumulation);
+            }
+        });
+
+        for (auto &[varOp, varAccumulations] : accumulations)
+        {
+            if (!isOnlyAccumulated(cast<mlir_ts::VariableOp>(varOp), varAccumulations, loopOp))
+            {
+                continue;
+            }
+
+            LLVM_DEBUG(llvm::dbgs() << "\n!! string builder for: " << *varOp << "\n";);
+
+            auto reference = cast<mlir_ts::VariableOp>(varOp).getReference();
+            auto stringType = mlir_ts::StringType::get(loopOp->getContext());
+
+            mlir::OpBuilder builder(loopOp);
+            auto loc = loopOp->getLoc();
+            auto value = builder.create<mlir_ts::LoadOp>(loc, stringType, reference);
+            auto buffer = builder.create<mlir_ts::StringBuilderOp>(loc, stringType, value);
+            builder.create<mlir_ts::StoreOp>(loc, buffer, reference);
+
+            for (auto &accumulation : varAccumulations)
+            {
+                auto lastBinOp = accumulation.binOps.front();
+                builder.setInsertionPoint(lastBinOp);
+                auto appendOp = builder.create<mlir_ts::StringAppendOp>(lastBinOp->getLoc(), stringType,
+                                                                        accumulation.loadOp, accumulation.pieces);
+                lastBinOp->replaceAllUsesWith(appendOp);
+
+                // from last to first concatenation
+                for (auto binOp : accumulation.binOps)
+                {
+                    binOp->erase();
+                }
+            }
+        }
+    }
+
+    // %v = ts.Load(%var); %r1 = ts.ArithmeticBinary(+, %v, %piece1); ... %rn = ...; ts.Store %rn, %var
+    mlir::Operation *getAccumulatedVariable(mlir_ts::StoreOp storeOp, mlir::Operation *loopOp,
+                                            Accumulation &accumulation)
+    {
+        accumulation.storeOp = storeOp;
+
+        auto value = storeOp.getValue();
+        while (auto binOp = value.getDefiningOp<mlir_ts::ArithmeticBinaryOp>())
+        {
+            if ((SyntaxKind)binOp.getOpCode() != SyntaxKind::PlusToken ||
+                !binOp.getType().isa<mlir_ts::StringType>() ||
+                !binOp.getOperand1().getType().isa<mlir_ts::StringType>() ||
+                !binOp.getOperand2().getType().isa<mlir_ts::StringType>() || !binOp->hasOneUse())
+            {
+                return nullptr;
+            }
+
+            accumulation.binOps.push_back(binOp);
+            accumulation.pieces.insert(accumulation.pieces.begin(), binOp.getOperand2());
+            value = binOp.getOperand1();
+        }
+
+        if (accumulation.binOps.empty())
+        {
+            return nullptr;
+        }
+
+        auto loadOp = value.getDefiningOp<mlir_ts::LoadOp>();
+        if (!loadOp || !loadOp->hasOneUse() || loadOp.getReference() != storeOp.getReference())
+        {
+            return nullptr;
+        }
+
+        accumulation.loadOp = loadOp;
+
+        auto varOp = loadOp.getReference().getDefiningOp<mlir_ts::VariableOp>();
+        if (!varOp || loopOp->isProperAncestor(varOp))
+        {
+            return nullptr;
+        }
+
+        return varOp;
+    }
+
+    bool isOnlyAccumulated(mlir_ts::VariableOp varOp, llvm::ArrayRef<Accumulation> varAccumulations,
+                           mlir::Operation *loopOp)
+    {
+        if (varOp.getCaptured().has_value() && varOp.getCaptured().value())
+        {
+            return false;
+        }
+
+        llvm::SmallPtrSet<mlir::Operation *, 8> accumulationOps;
+        for (auto &accumulation : varAccumulations)
+        {
+            accumulationOps.insert(accumulation.loadOp);
+            accumulationOps.insert(accumulation.storeOp);
+        }
+
+        auto reference = varOp.getReference();
+        for (auto *user : reference.getUsers())
+        {
+            if (loopOp->isProperAncestor(user))
+            {
+                if (!accumulationOps.count(user))
+                {
+                    return false;
+                }
+
+                continue;
+            }
+
+            if (isa<mlir_ts::LoadOp>(user))
+            {
+                continue;
+            }
+
+            if (auto storeOp = dyn_cast<mlir_ts::StoreOp>(user))
+            {
+                if (storeOp.getReference() == reference && storeOp.getValue() != reference)
+                {
+                    continue;
+                }
+            }
+
+            return false;
+        }
+
+        return true;
+    }
+};
+
+} // namespace
+
+std::unique_ptr<mlir::Pass> mlir_ts::createStringBuilderPass()
+{
+    return std::make_unique<StringBuilderPass>();
+}
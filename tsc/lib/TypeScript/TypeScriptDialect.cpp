@@ -322,6 +322,13 @@ void mlir_ts::TypeScriptDialect::initialize()
     addInterfaces<TypeScriptInlinerInterface>();
 }
 
+/// Materializes constants produced by op folders
+mlir::Operation *mlir_ts::TypeScriptDialect::materializeConstant(mlir::OpBuilder &builder, mlir::Attribute value, mlir::Type type,
+                                                               mlir::Location loc)
+{
+    return builder.create<mlir_ts::ConstantOp>(loc, type, value);
+}
+
 // The functions don't need to be in the header file, but need to be in the mlir
 // namespace. Declare them here, then define them immediately below. Separating
 // the declaration and definition adheres to the LLVM coding standards.
@@ -6,6 +6,7 @@
 #include "TypeScript/TypeScriptDialect.h"
 
 #include "TypeScript/MLIRLogic/MLIRTypeHelper.h"
+#include "TypeScript/MLIRLogic/TypeOfOpHelper.h"
 
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinTypes.h"
@@ -21,6 +22,8 @@
 #include "llvm/ADT/MapVector.h"
 #include "llvm/Support/Debug.h"
 
+#include "scanner_enums.h"
+
 using namespace mlir;
 namespace mlir_ts = mlir::typescript;
 
@@ -502,6 +505,494 @@ void mlir_ts::UndefOp::getCanonicalizationPatterns(RewritePatternSet &results, M
     results.insert<RemoveUnused<mlir_ts::UndefOp>>(context);
 }
 
+//===----------------------------------------------------------------------===//
+// Constant folding helpers
+//===----------------------------------------------------------------------===//
+
+namespace
+{
+mlir::Type stripLiteralType(mlir::Type type)
+{
+    if (auto literalType = type.dyn_cast<mlir_ts::LiteralType>())
+    {
+        return literalType.getElementType();
+    }
+
+    return type;
+}
+
+bool isNumberOrFloatType(mlir::Type type)
+{
+    return type.isa<mlir_ts::NumberType>() || type.isa<mlir::FloatType>();
+}
+
+bool isIntegerNotBoolType(mlir::Type type)
+{
+    return type.isa<mlir::IntegerType>() && !type.isInteger(1);
+}
+
+// float type used to store constants of 'number'
+mlir::FloatType getConstantFloatType(mlir::MLIRContext *context, mlir::Type type)
+{
+    if (auto floatType = type.dyn_cast<mlir::FloatType>())
+    {
+        return floatType;
+    }
+
+#ifdef NUMBER_F64
+    return mlir::Float64Type::get(context);
+#else
+    return mlir::Float32Type::get(context);
+#endif
+}
+
+mlir::BoolAttr getBoolAttr(mlir::MLIRContext *context, bool value)
+{
+    return mlir::BoolAttr::get(context, value);
+}
+
+// the same predicates as lowering of LogicalBinaryOp (signed compare for integers, ordered compare for floats)
+std::optional<bool> compareIntegers(SyntaxKind opCode, const APInt &lhs, const APInt &rhs)
+{
+    switch (opCode)
+    {
+    case SyntaxKind::EqualsEqualsToken:
+    case SyntaxKind::EqualsEqualsEqualsToken:
+        return lhs.eq(rhs);
+    case SyntaxKind::ExclamationEqualsToken:
+    case SyntaxKind::ExclamationEqualsEqualsToken:
+        return lhs.ne(rhs);
+    case SyntaxKind::GreaterThanToken:
+        return lhs.sgt(rhs);
+    case SyntaxKind::GreaterThanEqualsToken:
+        return lhs.sge(rhs);
+    case SyntaxKind::LessThanToken:
+        return lhs.slt(rhs);
+    case SyntaxKind::LessThanEqualsToken:
+        return lhs.sle(rhs);
+    default:
+        return std::nullopt;
+    }
+}
+
+std::optional<bool> compareFloats(SyntaxKind opCode, const APFloat &lhs, const APFloat &rhs)
+{
+    auto cmp = lhs.compare(rhs);
+    if (cmp == APFloat::cmpUnordered)
+    {
+        switch (opCode)
+        {
+        case SyntaxKind::EqualsEqualsToken:
+        case SyntaxKind::EqualsEqualsEqualsToken:
+        case SyntaxKind::ExclamationEqualsToken:
+        case SyntaxKind::ExclamationEqualsEqualsToken:
+        case SyntaxKind::GreaterThanToken:
+        case SyntaxKind::GreaterThanEqualsToken:
+        case SyntaxKind::LessThanToken:
+        case SyntaxKind::LessThanEqualsToken:
+            return false;
+        default:
+            return std::nullopt;
+        }
+    }
+
+    switch (opCode)
+    {
+    case SyntaxKind::EqualsEqualsToken:
+    case SyntaxKind::EqualsEqualsEqualsToken:
+        return cmp == APFloat::cmpEqual;
+    case SyntaxKind::ExclamationEqualsToken:
+    case SyntaxKind::ExclamationEqualsEqualsToken:
+        return cmp != APFloat::cmpEqual;
+    case SyntaxKind::GreaterThanToken:
+        return cmp == APFloat::cmpGreaterThan;
+    case SyntaxKind::GreaterThanEqualsToken:
+        return cmp == APFloat::cmpGreaterThan || cmp == APFloat::cmpEqual;
+    case SyntaxKind::LessThanToken:
+        return cmp == APFloat::cmpLessThan;
+    case SyntaxKind::LessThanEqualsToken:
+        return cmp == APFloat::cmpLessThan || cmp == APFloat::cmpEqual;
+    default:
+        return std::nullopt;
+    }
+}
+
+// the same result as 'strcmp' used in lowering of StringCompareOp
+std::optional<bool> compareStrings(SyntaxKind opCode, StringRef lhs, StringRef rhs)
+{
+    lhs = lhs.substr(0, lhs.find('\0'));
+    rhs = rhs.substr(0, rhs.find('\0'));
+    APInt cmp(32, lhs.compare(rhs), true);
+    return compareIntegers(opCode, cmp, APInt(32, 0));
+}
+} // end anonymous namespace.
+
+//===----------------------------------------------------------------------===//
+// ArithmeticUnaryOp
+//===----------------------------------------------------------------------===//
+
+OpFoldResult mlir_ts::ArithmeticUnaryOp::fold(FoldAdaptor adaptor)
+{
+    auto opCode = (SyntaxKind)getOpCode();
+    auto resultType = getType();
+    if (opCode == SyntaxKind::PlusToken && getOperand1().getType() == resultType)
+    {
+        return getOperand1();
+    }
+
+    auto operand = adaptor.getOperand1();
+    if (!operand)
+    {
+        return {};
+    }
+
+    if (auto floatAttr = operand.dyn_cast<mlir::FloatAttr>())
+    {
+        if (opCode == SyntaxKind::MinusToken && isNumberOrFloatType(resultType))
+        {
+            return mlir::FloatAttr::get(floatAttr.getType(), -floatAttr.getValue());
+        }
+
+        return {};
+    }
+
+    if (auto intAttr = operand.dyn_cast<mlir::IntegerAttr>())
+    {
+        auto value = intAttr.getValue();
+        if (opCode == SyntaxKind::ExclamationToken && value.getBitWidth() == 1 && resultType.isa<mlir_ts::BooleanType>())
+        {
+            return getBoolAttr(getContext(), value.isZero());
+        }
+
+        if (!isIntegerNotBoolType(resultType))
+        {
+            return {};
+        }
+
+        value = value.sextOrTrunc(resultType.getIntOrFloatBitWidth());
+        switch (opCode)
+        {
+        case SyntaxKind::MinusToken:
+            return mlir::IntegerAttr::get(resultType, -value);
+        case SyntaxKind::TildeToken:
+            return mlir::IntegerAttr::get(resultType, ~value);
+        default:
+            return {};
+        }
+    }
+
+    return {};
+}
+
+//===----------------------------------------------------------------------===//
+// ArithmeticBinaryOp
+//===----------------------------------------------------------------------===//
+
+OpFoldResult mlir_ts::ArithmeticBinaryOp::fold(FoldAdaptor adaptor)
+{
+    auto lhs = adaptor.getOperand1();
+    auto rhs = adaptor.getOperand2();
+    if (!lhs || !rhs)
+    {
+        return {};
+    }
+
+    auto opCode = (SyntaxKind)getOpCode();
+    auto resultType = getType();
+
+    auto lhsStr = lhs.dyn_cast<mlir::StringAttr>();
+    auto rhsStr = rhs.dyn_cast<mlir::StringAttr>();
+    if (lhsStr || rhsStr)
+    {
+        if (lhsStr && rhsStr && opCode == SyntaxKind::PlusToken && resultType.isa<mlir_ts::StringType>())
+        {
+            return mlir::StringAttr::get(getContext(), lhsStr.getValue() + rhsStr.getValue());
+        }
+
+        return {};
+    }
+
+    auto lhsFloat = lhs.dyn_cast<mlir::FloatAttr>();
+    auto rhsFloat = rhs.dyn_cast<mlir::FloatAttr>();
+    if (lhsFloat && rhsFloat)
+    {
+        if (!isNumberOrFloatType(resultType) || lhsFloat.getType() != rhsFloat.getType())
+        {
+            return {};
+        }
+
+        auto value = lhsFloat.getValue();
+        auto rhsValue = rhsFloat.getValue();
+        switch (opCode)
+        {
+        case SyntaxKind::PlusToken:
+            value.add(rhsValue, APFloat::rmNearestTiesToEven);
+            break;
+        case SyntaxKind::MinusToken:
+            value.subtract(rhsValue, APFloat::rmNearestTiesToEven);
+            break;
+        case SyntaxKind::AsteriskToken:
+            value.multiply(rhsValue, APFloat::rmNearestTiesToEven);
+            break;
+        case SyntaxKind::SlashToken:
+            value.divide(rhsValue, APFloat::rmNearestTiesToEven);
+            break;
+        case SyntaxKind::PercentToken:
+            value.mod(rhsValue);
+            break;
+        case SyntaxKind::AsteriskAsteriskToken:
+            if (&value.getSemantics() != &APFloat::IEEEdouble())
+            {
+                return {};
+            }
+
+            value = APFloat(std::pow(value.convertToDouble(), rhsValue.convertToDouble()));
+            break;
+        default:
+            // bitwise operations are not folded for floats
+            return {};
+        }
+
+        return mlir::FloatAttr::get(lhsFloat.getType(), value);
+    }
+
+    auto lhsInt = lhs.dyn_cast<mlir::IntegerAttr>();
+    auto rhsInt = rhs.dyn_cast<mlir::IntegerAttr>();
+    if (lhsInt && rhsInt)
+    {
+        if (!isIntegerNotBoolType(resultType))
+        {
+            return {};
+        }
+
+        auto width = resultType.getIntOrFloatBitWidth();
+        auto isUnsigned = resultType.isUnsignedInteger();
+        auto value = lhsInt.getValue().sextOrTrunc(width);
+        auto rhsValue = rhsInt.getValue().sextOrTrunc(width);
+        switch (opCode)
+        {
+        case SyntaxKind::PlusToken:
+            value += rhsValue;
+            break;
+        case SyntaxKind::MinusToken:
+            value -= rhsValue;
+            break;
+        case SyntaxKind::AsteriskToken:
+            value *= rhsValue;
+            break;
+        case SyntaxKind::AmpersandToken:
+            value &= rhsValue;
+            break;
+        case SyntaxKind::BarToken:
+            value |= rhsValue;
+            break;
+        case SyntaxKind::CaretToken:
+            value ^= rhsValue;
+            break;
+        case SyntaxKind::LessThanLessThanToken:
+        case SyntaxKind::GreaterThanGreaterThanToken:
+        case SyntaxKind::GreaterThanGreaterThanGreaterThanToken:
+            // shift by amount bigger than bit width is poison in LLVM
+            if (rhsValue.uge(width))
+            {
+                return {};
+            }
+
+            value = opCode == SyntaxKind::LessThanLessThanToken ? value.shl(rhsValue)
+                    : opCode == SyntaxKind::GreaterThanGreaterThanToken && !isUnsigned ? value.ashr(rhsValue)
+                    : value.lshr(rhsValue);
+            break;
+        case SyntaxKind::SlashToken:
+        case SyntaxKind::PercentToken:
+            // keep runtime behavior for division by zero and overflow
+            if (rhsValue.isZero() || (!isUnsigned && rhsValue.isAllOnes() && value.isMinSignedValue()))
+            {
+                return {};
+            }
+
+            value = opCode == SyntaxKind::SlashToken ? (isUnsigned ? value.udiv(rhsValue) : value.sdiv(rhsValue))
+                                                     : (isUnsigned ? value.urem(rhsValue) : value.srem(rhsValue));
+            break;
+        default:
+            return {};
+        }
+
+        return mlir::IntegerAttr::get(resultType, value);
+    }
+
+    return {};
+}
+
+Speculation::Speculatability mlir_ts::ArithmeticBinaryOp::getSpeculatability()
+{
+    switch ((SyntaxKind)getOpCode())
+    {
+    case SyntaxKind::SlashToken:
+    case SyntaxKind::PercentToken:
+        break;
+    default:
+        return Speculation::Speculatable;
+    }
+
+    // floating point division does not trap
+    auto divisorType = getOperand2().getType();
+    if (!divisorType.isa<mlir::IntegerType>() && !divisorType.isa<mlir::IndexType>())
+    {
+        return Speculation::Speculatable;
+    }
+
+    // integer division is safe to hoist only when divisor is known constant which is not 0 or -1
+    mlir::IntegerAttr divisor;
+    if (matchPattern(getOperand2(), m_Constant(&divisor)) && !divisor.getValue().isZero() &&
+        !divisor.getValue().isAllOnes())
+    {
+        return Speculation::Speculatable;
+    }
+
+    return Speculation::NotSpeculatable;
+}
+
+//===----------------------------------------------------------------------===//
+// LogicalBinaryOp
+//===----------------------------------------------------------------------===//
+
+OpFoldResult mlir_ts::LogicalBinaryOp::fold(FoldAdaptor adaptor)
+{
+    auto lhs = adaptor.getOperand1();
+    auto rhs = adaptor.getOperand2();
+    if (!lhs || !rhs)
+    {
+        return {};
+    }
+
+    // optional, undefined and reference types have own compare logic
+    auto lhsType = stripLiteralType(getOperand1().getType());
+    auto rhsType = stripLiteralType(getOperand2().getType());
+    if (lhsType != rhsType)
+    {
+        return {};
+    }
+
+    auto opCode = (SyntaxKind)getOpCode();
+    std::optional<bool> result;
+    if (lhsType.isa<mlir_ts::StringType>())
+    {
+        auto lhsStr = lhs.dyn_cast<mlir::StringAttr>();
+        auto rhsStr = rhs.dyn_cast<mlir::StringAttr>();
+        if (lhsStr && rhsStr)
+        {
+            result = compareStrings(opCode, lhsStr.getValue(), rhsStr.getValue());
+        }
+    }
+    else if (isNumberOrFloatType(lhsType))
+    {
+        auto lhsFloat = lhs.dyn_cast<mlir::FloatAttr>();
+        auto rhsFloat = rhs.dyn_cast<mlir::FloatAttr>();
+        if (lhsFloat && rhsFloat && lhsFloat.getType() == rhsFloat.getType())
+        {
+            result = compareFloats(opCode, lhsFloat.getValue(), rhsFloat.getValue());
+        }
+    }
+    else if (lhsType.isa<mlir::IntegerType>() || lhsType.isa<mlir_ts::BooleanType>())
+    {
+        auto lhsInt = lhs.dyn_cast<mlir::IntegerAttr>();
+        auto rhsInt = rhs.dyn_cast<mlir::IntegerAttr>();
+        if (lhsInt && rhsInt && lhsInt.getValue().getBitWidth() == rhsInt.getValue().getBitWidth())
+        {
+            result = compareIntegers(opCode, lhsInt.getValue(), rhsInt.getValue());
+        }
+    }
+
+    if (!result.has_value())
+    {
+        return {};
+    }
+
+    return getBoolAttr(getContext(), result.value());
+}
+
+//===----------------------------------------------------------------------===//
+// TypeOfOp
+//===----------------------------------------------------------------------===//
+
+OpFoldResult mlir_ts::TypeOfOp::fold(FoldAdaptor adaptor)
+{
+    // value of any, union and optional types is known only in runtime
+    auto type = getValue().getType();
+    if (!getType().isa<mlir_ts::StringType>() || type.isa<mlir_ts::AnyType>() || type.isa<mlir_ts::UnionType>() ||
+        type.isa<mlir_ts::OptionalType>())
+    {
+        return {};
+    }
+
+    auto name = ::typescript::TypeOfOpHelper::typeOfName(type);
+    if (name.empty())
+    {
+        return {};
+    }
+
+    return mlir::StringAttr::get(getContext(), name);
+}
+
+//===----------------------------------------------------------------------===//
+// StringLengthOp
+//===----------------------------------------------------------------------===//
+
+OpFoldResult mlir_ts::StringLengthOp::fold(FoldAdaptor adaptor)
+{
+    auto strAttr = adaptor.getOp().dyn_cast_or_null<mlir::StringAttr>();
+    if (!strAttr)
+    {
+        return {};
+    }
+
+    // length is computed by strlen at runtime, so it ends at first null
+    return mlir::IntegerAttr::get(getType(), strAttr.getValue().take_until([](char c) { return c == '\0'; }).size());
+}
+
+//===----------------------------------------------------------------------===//
+// StringConcatOp
+//===----------------------------------------------------------------------===//
+
+OpFoldResult mlir_ts::StringConcatOp::fold(FoldAdaptor adaptor)
+{
+    std::string result;
+    for (auto operand : adaptor.getOps())
+    {
+        auto strAttr = operand.dyn_cast_or_null<mlir::StringAttr>();
+        if (!strAttr)
+        {
+            return {};
+        }
+
+        result += strAttr.getValue();
+    }
+
+    return mlir::StringAttr::get(getContext(), result);
+}
+
+//===----------------------------------------------------------------------===//
+// StringCompareOp
+//===----------------------------------------------------------------------===//
+
+OpFoldResult mlir_ts::StringCompareOp::fold(FoldAdaptor adaptor)
+{
+    auto lhsStr = adaptor.getOp1().dyn_cast_or_null<mlir::StringAttr>();
+    auto rhsStr = adaptor.getOp2().dyn_cast_or_null<mlir::StringAttr>();
+    if (!lhsStr || !rhsStr)
+    {
+        return {};
+    }
+
+    auto result = compareStrings((SyntaxKind)getCode(), lhsStr.getValue(), rhsStr.getValue());
+    if (!result.has_value())
+    {
+        return {};
+    }
+
+    return getBoolAttr(getContext(), result.value());
+}
+
 //===----------------------------------------------------------------------===//
 // CastOp
 //===----------------------------------------------------------------------===//
@@ -713,6 +1204,88 @@ void mlir_ts::CastOp::getCanonicalizationPatterns(RewritePatternSet &results, ML
     results.insert<NormalizeCast>(context);
 }
 
+// folds casts of constants between numeric and boolean types, the same way as CastLogicHelper does in runtime
+OpFoldResult mlir_ts::CastOp::fold(FoldAdaptor adaptor)
+{
+    auto in = adaptor.getIn();
+    if (!in)
+    {
+        return {};
+    }
+
+    auto inType = stripLiteralType(getIn().getType());
+    auto resType = getType();
+
+    if (auto intAttr = in.dyn_cast<mlir::IntegerAttr>())
+    {
+        auto value = intAttr.getValue();
+        auto isBool = inType.isa<mlir_ts::BooleanType>();
+        if (!isBool && !isIntegerNotBoolType(inType))
+        {
+            return {};
+        }
+
+        if (resType.isa<mlir_ts::BooleanType>())
+        {
+            return getBoolAttr(getContext(), !value.isZero());
+        }
+
+        if (isNumberOrFloatType(resType))
+        {
+            auto floatType = getConstantFloatType(getContext(), resType);
+            APFloat floatValue(floatType.getFloatSemantics());
+            floatValue.convertFromAPInt(value, !isBool, APFloat::rmNearestTiesToEven);
+            return mlir::FloatAttr::get(floatType, floatValue);
+        }
+
+        if (isIntegerNotBoolType(resType))
+        {
+            // integers are zero extended
+            return mlir::IntegerAttr::get(resType, value.zextOrTrunc(resType.getIntOrFloatBitWidth()));
+        }
+
+        return {};
+    }
+
+    if (auto floatAttr = in.dyn_cast<mlir::FloatAttr>())
+    {
+        if (!isNumberOrFloatType(inType))
+        {
+            return {};
+        }
+
+        auto value = floatAttr.getValue();
+        if (resType.isa<mlir_ts::BooleanType>())
+        {
+            return getBoolAttr(getContext(), !value.isZero() && !value.isNaN());
+        }
+
+        if (isIntegerNotBoolType(resType))
+        {
+            APSInt intValue(resType.getIntOrFloatBitWidth(), /*isUnsigned=*/false);
+            bool isExact;
+            if (value.convertToInteger(intValue, APFloat::rmTowardZero, &isExact) & APFloat::opInvalidOp)
+            {
+                return {};
+            }
+
+            return mlir::IntegerAttr::get(resType, intValue);
+        }
+
+        if (isNumberOrFloatType(resType))
+        {
+            auto floatType = getConstantFloatType(getContext(), resType);
+            bool losesInfo;
+            value.convert(floatType.getFloatSemantics(), APFloat::rmNearestTiesToEven, &losesInfo);
+            return mlir::FloatAttr::get(floatType, value);
+        }
+
+        return {};
+    }
+
+    return {};
+}
+
 /// Returns true if the given set of input and result types are compatible with
 /// this cast operation. This is required by the `CastOpInterface` to verify
 /// this operation and provide other additional utilities.
@@ -0,0 +1,547 @@
+#include <charconv>
+#include <cinttypes>
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "llvm/ADT/StringMap.h"
+
+//===----------------------------------------------------------------------===//
+// Number runtime API.
+//===----------------------------------------------------------------------===//
+
+namespace mlir
+{
+namespace runtime
+{
+
+// writes digits of value in reverse order, returns end of digits
+static char *writeReversedDigits(uint64_t value, char *buffer)
+{
+    do
+    {
+        *buffer++ = '0' + (char)(value % 10);
+        value /= 10;
+    } while (value);
+
+    return buffer;
+}
+
+static char *writeUnsigned(uint64_t value, bool negative, char *buffer)
+{
+    char digits[24];
+    auto *end = writeReversedDigits(value, digits);
+
+    auto *out = buffer;
+    if (negative)
+    {
+        *out++ = '-';
+    }
+
+    while (end != digits)
+    {
+        *out++ = *--end;
+    }
+
+    *out = '\0';
+    return buffer;
+}
+
+extern "C" char *ts_int32_to_string(int32_t value, char *buffer)
+{
+    auto negative = value < 0;
+    return writeUnsigned(negative ? 0 - (uint64_t)(int64_t)value : (uint64_t)value, negative, buffer);
+}
+
+extern "C" char *ts_int64_to_string(int64_t value, char *buffer)
+{
+    auto negative = value < 0;
+    return writeUnsigned(negative ? 0 - (uint64_t)value : (uint64_t)value, negative, buffer);
+}
+
+extern "C" char *ts_uint64_to_string(uint64_t value, char *buffer)
+{
+    return writeUnsigned(value, false, buffer);
+}
+
+// shortest digits of positive finite value which read back as the same value in format d.ddddde[+-]xx, returns end
+static char *writeShortestScientific(double value, char *buffer, size_t size)
+{
+#if __cpp_lib_to_chars >= 201611L
+    return std::to_chars(buffer, buffer + size, value, std::chars_format::scientific).ptr;
+#else
+    // floating point std::to_chars is not available (libstdc++ before GCC 11): fewest digits which round-trip
+    auto length = 0;
+    for (auto precision = 0; precision < std::numeric_limits<double>::max_digits10; precision++)
+    {
+        length = std::snprintf(buffer, size, "%.*e", precision, value);
+        if (std::strtod(buffer, nullptr) == value)
+        {
+            break;
+        }
+    }
+
+    // decimal point of current locale
+    for (auto *pos = buffer; *pos && *pos != 'e'; pos++)
+    {
+        if (*pos != '-' && *pos != '+' && (*pos < '0' || *pos > '9'))
+        {
+            *pos = '.';
+        }
+    }
+
+    return buffer + length;
+#endif
+}
+
+// ECMAScript Number::toString (radix 10): shortest digits which read back as the same value, placed by rules of the
+// spec: plain notation for 1e-7 <= |value| < 1e21, exponential otherwise. Buffer must have at least 32 bytes.
+extern "C" char *ts_number_to_string(double value, char *buffer)
+{
+    if (std::isnan(value))
+    {
+        std::memcpy(buffer, "NaN", 4);
+        return buffer;
+    }
+
+    // +0 and -0
+    if (value == 0)
+    {
+        std::memcpy(buffer, "0", 2);
+        return buffer;
+    }
+
+    auto *out = buffer;
+    if (value < 0)
+    {
+        *out++ = '-';
+        value = -value;
+    }
+
+    if (std::isinf(value))
+    {
+        std::memcpy(out, "Infinity", 9);
+        return buffer;
+    }
+
+    // d.ddddde[+-]xx
+    char scientific[32];
+    auto *end = writeShortestScientific(value, scientific, sizeof(scientific));
+
+    // k digits, value = digits * 10^(n - k)
+    char digits[20];
+    int k = 0;
+    auto *pos = scientific;
+    for (; pos != end && *pos != 'e'; pos++)
+    {
+        if (*pos != '.')
+        {
+            digits[k++] = *pos;
+        }
+    }
+
+    int exponent = 0;
+    std::from_chars(pos + 1 + (pos[1] == '+' ? 1 : 0), end, exponent);
+    auto n = exponent + 1;
+
+    if (k <= n && n <= 21)
+    {
+        // integer: digits followed by n - k zeros
+        std::memcpy(out, digits, k);
+        out += k;
+        std::memset(out, '0', n - k);
+        out += n - k;
+    }
+    else if (0 < n && n <= 21)
+    {
+        std::memcpy(out, digits, n);
+        out += n;
+        *out++ = '.';
+        std::memcpy(out, digits + n, k - n);
+        out += k - n;
+    }
+    else if (-6 < n && n <= 0)
+    {
+        *out++ = '0';
+        *out++ = '.';
+        std::memset(out, '0', -n);
+        out += -n;
+        std::memcpy(out, digits, k);
+        out += k;
+    }
+    else
+    {
+        *out++ = digits[0];
+        if (k > 1)
+        {
+            *out++ = '.';
+            std::memcpy(out, digits + 1, k - 1);
+            out += k - 1;
+        }
+
+        *out++ = 'e';
+        *out++ = n - 1 < 0 ? '-' : '+';
+        auto absExponent = n - 1 < 0 ? 1 - n : n - 1;
+        char exponentDigits[8];
+        auto *exponentEnd = writeReversedDigits(absExponent, exponentDigits);
+        while (exponentEnd != exponentDigits)
+        {
+            *out++ = *--exponentEnd;
+        }
+    }
+
+    *out = '\0';
+    return buffer;
+}
+
+// ECMAScript WhiteSpace and LineTerminator in UTF-8, returns size of the sequence or 0
+static int whiteSpaceSize(const char *str)
+{
+    auto *s = reinterpret_cast<const unsigned char *>(str);
+    switch (s[0])
+    {
+    case '\t':
+    case '\n':
+    case '\v':
+    case '\f':
+    case '\r':
+    case ' ':
+        return 1;
+    case 0xC2:
+        // U+00A0
+        return s[1] == 0xA0 ? 2 : 0;
+    case 0xE1:
+        // U+1680
+        return s[1] == 0x9A && s[2] == 0x80 ? 3 : 0;
+    case 0xE2:
+        // U+2000..U+200A, U+2028, U+2029, U+202F
+        if (s[1] == 0x80 && ((s[2] >= 0x80 && s[2] <= 0x8A) || s[2] == 0xA8 || s[2] == 0xA9 || s[2] == 0xAF))
+        {
+            return 3;
+        }
+
+        // U+205F
+        return s[1] == 0x81 && s[2] == 0x9F ? 3 : 0;
+    case 0xE3:
+        // U+3000
+        return s[1] == 0x80 && s[2] == 0x80 ? 3 : 0;
+    case 0xEF:
+        // U+FEFF
+        return s[1] == 0xBB && s[2] == 0xBF ? 3 : 0;
+    }
+
+    return 0;
+}
+
+static const char *skipWhiteSpaces(const char *str)
+{
+    while (auto size = whiteSpaceSize(str))
+    {
+        str += size;
+    }
+
+    return str;
+}
+
+static bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// value of digit in radix up to 36 or -1
+static int digitValue(char c, int radix)
+{
+    int value = -1;
+    if (c >= '0' && c <= '9')
+    {
+        value = c - '0';
+    }
+    else if (c >= 'a' && c <= 'z')
+    {
+        value = c - 'a' + 10;
+    }
+    else if (c >= 'A' && c <= 'Z')
+    {
+        value = c - 'A' + 10;
+    }
+
+    return value < radix ? value : -1;
+}
+
+// value of decimal literal (already validated, without sign), independent of locale
+static double decimalLiteralValue(const char *start, const char *end)
+{
+#if __cpp_lib_to_chars >= 201611L
+    // Eisel-Lemire fast path in standard libraries
+    double value;
+    auto result = std::from_chars(start, end, value, std::chars_format::general);
+    if (result.ec != std::errc::result_out_of_range)
+    {
+        return value;
+    }
+#endif
+
+    // floating point std::from_chars is not available (libstdc++ before GCC 11) or value overflows to infinity or
+    // underflows to zero: strtod expects decimal point of current locale
+    std::string literal(start, end);
+    auto point = literal.find('.');
+    if (point != std::string::npos)
+    {
+        literal.replace(point, 1, std::localeconv()->decimal_point);
+    }
+
+    return std::strtod(literal.c_str(), nullptr);
+}
+
+// StrDecimalLiteral: [+-] (Infinity | digits [. digits] [e [+-] digits] | . digits [e [+-] digits]), longest prefix
+// is parsed, returns end of literal (str if there is no literal)
+static const char *parseDecimalLiteral(const char *str, double &value)
+{
+    auto *pos = str;
+    auto negative = false;
+    if (*pos == '+' || *pos == '-')
+    {
+        negative = *pos == '-';
+        pos++;
+    }
+
+    if (std::strncmp(pos, "Infinity", 8) == 0)
+    {
+        value = negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+        return pos + 8;
+    }
+
+    auto *start = pos;
+    auto hasDigits = false;
+    while (isDigit(*pos))
+    {
+        pos++;
+        hasDigits = true;
+    }
+
+    if (*pos == '.')
+    {
+        auto *fraction = pos + 1;
+        while (isDigit(*fraction))
+        {
+            fraction++;
+            hasDigits = true;
+        }
+
+        if (hasDigits)
+        {
+            pos = fraction;
+        }
+    }
+
+    if (!hasDigits)
+    {
+        return str;
+    }
+
+    if (*pos == 'e' || *pos == 'E')
+    {
+        auto *exponent = pos + 1;
+        if (*exponent == '+' || *exponent == '-')
+        {
+            exponent++;
+        }
+
+        if (isDigit(*exponent))
+        {
+            while (isDigit(*exponent))
+            {
+                exponent++;
+            }
+
+            pos = exponent;
+        }
+    }
+
+    value = decimalLiteralValue(start, pos);
+    if (negative)
+    {
+        value = -value;
+    }
+
+    return pos;
+}
+
+// ECMAScript parseFloat
+extern "C" double ts_parse_float(const char *str)
+{
+    if (!str)
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    auto *start = skipWhiteSpaces(str);
+    double value;
+    if (parseDecimalLiteral(start, value) == start)
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    return value;
+}
+
+// ECMAScript parseInt, NaN is 0 as result is integer
+extern "C" int64_t ts_parse_int(const char *str, int32_t radix)
+{
+    if (!str)
+    {
+        return 0;
+    }
+
+    auto *pos = skipWhiteSpaces(str);
+    auto negative = false;
+    if (*pos == '+' || *pos == '-')
+    {
+        negative = *pos == '-';
+        pos++;
+    }
+
+    auto stripPrefix = true;
+    if (radix != 0)
+    {
+        if (radix < 2 || radix > 36)
+        {
+            return 0;
+        }
+
+        stripPrefix = radix == 16;
+    }
+    else
+    {
+        radix = 10;
+    }
+
+    if (stripPrefix && pos[0] == '0' && (pos[1] == 'x' || pos[1] == 'X'))
+    {
+        pos += 2;
+        radix = 16;
+    }
+
+    double value = 0;
+    for (int digit; (digit = digitValue(*pos, radix)) >= 0; pos++)
+    {
+        value = value * radix + digit;
+    }
+
+    if (value >= 0x1p63)
+    {
+        return negative ? std::numeric_limits<int64_t>::min() : std::numeric_limits<int64_t>::max();
+    }
+
+    return negative ? -(int64_t)value : (int64_t)value;
+}
+
+// ECMAScript ToNumber applied to String (implicit conversions): whitespace around, empty string is 0, 0x/0o/0b
+// integers, decimal literal which takes the whole string, otherwise NaN
+extern "C" double ts_string_to_number(const char *str)
+{
+    if (!str)
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    auto *start = skipWhiteSpaces(str);
+    auto *end = start + std::strlen(start);
+    for (auto trimmed = true; trimmed;)
+    {
+        // whitespaces are 1-3 bytes
+        trimmed = false;
+        for (auto size = 1; size <= 3 && end - size >= start; size++)
+        {
+            if (whiteSpaceSize(end - size) == size)
+            {
+                end -= size;
+                trimmed = true;
+                break;
+            }
+        }
+    }
+
+    if (start == end)
+    {
+        return 0;
+    }
+
+    if (start[0] == '0' && end - start > 2)
+    {
+        int radix = 0;
+        switch (start[1])
+        {
+        case 'x':
+        case 'X':
+            radix = 16;
+            break;
+        case 'o':
+        case 'O':
+            radix = 8;
+            break;
+        case 'b':
+        case 'B':
+            radix = 2;
+            break;
+        }
+
+        if (radix)
+        {
+            double value = 0;
+            for (auto *pos = start + 2; pos < end; pos++)
+            {
+                auto digit = digitValue(*pos, radix);
+                if (digit < 0)
+                {
+                    return std::numeric_limits<double>::quiet_NaN();
+                }
+
+                value = value * radix + digit;
+            }
+
+            return value;
+        }
+    }
+
+    double value;
+    if (parseDecimalLiteral(start, value) != end)
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    return value;
+}
+
+} // namespace runtime
+} // namespace mlir
+
+//===----------------------------------------------------------------------===//
+// MLIR Runner (JitRunner) dynamic library integration.
+//===----------------------------------------------------------------------===//
+
+// NOLINTNEXTLINE(*-identifier-naming): externally called.
+void init_numberruntime(llvm::StringMap<void *> &exportSymbols)
+{
+    auto exportSymbol = [&](llvm::StringRef name, auto ptr) {
+        assert(exportSymbols.count(name) == 0 && "symbol already exists");
+        exportSymbols[name] = reinterpret_cast<void *>(ptr);
+    };
+
+    exportSymbol("ts_int32_to_string", &mlir::runtime::ts_int32_to_string);
+    exportSymbol("ts_int64_to_string", &mlir::runtime::ts_int64_to_string);
+    exportSymbol("ts_uint64_to_string", &mlir::runtime::ts_uint64_to_string);
+    exportSymbol("ts_number_to_string", &mlir::runtime::ts_number_to_string);
+    exportSymbol("ts_parse_float", &mlir::runtime::ts_parse_float);
+    exportSymbol("ts_parse_int", &mlir::runtime::ts_parse_int);
+    exportSymbol("ts_string_to_number", &mlir::runtime::ts_string_to_number);
+}
+
+// NOLINTNEXTLINE(*-identifier-naming): externally called.
+void destroy_numberruntime()
+{
+}
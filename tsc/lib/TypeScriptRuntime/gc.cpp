@@ -49,6 +49,17 @@ void _mlir__GC_free(void *ptr)
     GC_FREE(ptr);
 }
 
+size_t _mlir__GC_size(void *ptr)
+{
+#ifdef GC_DEBUG
+    // debug object is preceded by debug header ending with requested size (oh_sz) and start flag (oh_sf) and is
+    // followed by end flag, so only requested size is usable, not size of whole block
+    return static_cast<size_t>(reinterpret_cast<const GC_word *>(ptr)[-2]);
+#else
+    return GC_size(ptr);
+#endif
+}
+
 size_t _mlir__GC_get_heap_size()
 {
     return GC_get_heap_size();
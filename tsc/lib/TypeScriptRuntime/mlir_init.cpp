@@ -18,6 +18,9 @@ void destroy_asyncruntime();
 void init_dynamicruntime(llvm::StringMap<void *> &exportSymbols);
 void destroy_dynamicruntime();
 
+void init_numberruntime(llvm::StringMap<void *> &exportSymbols);
+void destroy_numberruntime();
+
 // Export symbols for the MLIR runner integration. All other symbols are hidden.
 #ifdef _WIN32
 #define API __declspec(dllexport)
@@ -34,6 +37,7 @@ void __mlir_runner_init(llvm::StringMap<void *> &exportSymbols)
     init_memruntime(exportSymbols);
     init_asyncruntime(exportSymbols);
     init_dynamicruntime(exportSymbols);
+    init_numberruntime(exportSymbols);
 }
 
 extern "C" API void __mlir_runner_destroy()
@@ -42,4 +46,5 @@ extern "C" API void __mlir_runner_destroy()
     //destory_memruntime();
     destroy_asyncruntime();
     destroy_dynamicruntime();
+    destroy_numberruntime();
 }
\ No newline at end of file
@@ -0,0 +1,53 @@
+function sumAny(values: any[]) {
+    let sum = 0;
+    for (const v of values) {
+        if (typeof v == "number") sum += <number>v;
+    }
+
+    return sum;
+}
+
+function main() {
+    // numbers, including special values
+    const n: any = 1.5;
+    assert(typeof n == "number", "typeof number");
+    assert(<number>n == 1.5, "number");
+
+    const neg: any = -0.25;
+    assert(<number>neg == -0.25, "negative");
+
+    const inf: any = -Infinity;
+    assert(<number>inf == -Infinity, "infinity");
+
+    const nan: any = 0 / 0;
+    assert(typeof nan == "number", "typeof NaN");
+    const nanBack = <number>nan;
+    assert(nanBack != nanBack, "NaN");
+
+    const zero: any = -0;
+    assert(1 / <number>zero < 0, "minus zero");
+
+    // booleans
+    const t: any = true;
+    const f: any = false;
+    assert(typeof t == "boolean", "typeof boolean");
+    assert(<boolean>t, "true");
+    assert(!<boolean>f, "false");
+
+    // values in boxes
+    const s: any = "text";
+    assert(typeof s == "string", "typeof string");
+    assert(<string>s == "text", "string");
+
+    // boxing in loop
+    const values: any[] = [];
+    for (let i = 0; i < 1000; i++) {
+        values.push(i);
+        values.push(i % 2 == 0);
+    }
+
+    values.push("skip");
+    assert(sumAny(values) == 499500, "sum");
+
+    print("done.");
+}
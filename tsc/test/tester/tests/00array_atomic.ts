@@ -0,0 +1,54 @@
+class Node {
+    constructor(public value: number, public next?: Node) {}
+}
+
+function makeNumbers(n: number) {
+    const a: number[] = [];
+    for (let i = 0; i < n; i++) {
+        a.push(i);
+    }
+
+    return a;
+}
+
+function main() {
+    // arrays of values are pointer-free
+    let total = 0;
+    for (let j = 0; j < 100; j++) {
+        const a = makeNumbers(100);
+        total += a[99];
+    }
+
+    assert(total == 9900, "numbers");
+
+    // values in captured variables
+    let count = 0;
+    const inc = () => { count++; };
+    for (let j = 0; j < 10; j++) inc();
+    assert(count == 10, "captured");
+
+    // objects referencing each other must stay alive
+    let list: Node = undefined;
+    for (let i = 0; i < 1000; i++) {
+        list = new Node(i, list);
+        const garbage = makeNumbers(10);
+        assert(garbage.length == 10, "garbage");
+    }
+
+    let sum = 0;
+    for (let n = list; n; n = n.next) {
+        sum += n.value;
+    }
+
+    assert(sum == 499500, "list");
+
+    // strings are pointer-free
+    let s = "";
+    for (let i = 0; i < 10; i++) {
+        s = s + "a";
+    }
+
+    assert(s.length == 10, "string");
+
+    print("done.");
+}
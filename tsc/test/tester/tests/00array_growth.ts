@@ -0,0 +1,54 @@
+class Item {
+    constructor(public value: number) {}
+}
+
+function main() {
+    // many pushes: block grows geometrically
+    const numbers: number[] = [];
+    for (let i = 0; i < 100000; i++) {
+        numbers.push(i);
+    }
+
+    assert(numbers.length == 100000, "length");
+    assert(numbers[0] == 0 && numbers[99999] == 99999, "values");
+
+    let sum = 0;
+    for (const n of numbers) {
+        sum += n;
+    }
+
+    assert(sum == 4999950000, "sum");
+
+    // several items in one push
+    const pairs: number[] = [1];
+    for (let i = 0; i < 1000; i++) {
+        pairs.push(i, i);
+    }
+
+    assert(pairs.length == 2001, "pairs");
+    assert(pairs[2000] == 999, "last pair");
+
+    // pop keeps capacity, push after pop reuses it
+    for (let i = 0; i < 50000; i++) {
+        numbers.pop();
+    }
+
+    assert(numbers.length == 50000, "after pop");
+    numbers.push(-1);
+    assert(numbers[50000] == -1, "push after pop");
+    assert(numbers[49999] == 49999, "kept value");
+
+    // references
+    const items: Item[] = [];
+    for (let i = 0; i < 1000; i++) {
+        items.push(new Item(i));
+    }
+
+    const last = items.pop();
+    assert(last.value == 999, "popped item");
+    assert(items.length == 999, "items length");
+    items.push(new Item(7));
+    assert(items[999].value == 7, "pushed item");
+
+    print("done.");
+}
@@ -0,0 +1,74 @@
+// single implementation, call can be direct
+class Counter {
+    value = 0;
+
+    inc(step: number) {
+        this.value += step;
+        return this.value;
+    }
+}
+
+// few implementations, calls are guarded by class
+class Shape {
+    area() {
+        return 0;
+    }
+
+    name() {
+        return "shape";
+    }
+}
+
+class Square extends Shape {
+    constructor(public side: number) {
+        super();
+    }
+
+    area() {
+        return this.side * this.side;
+    }
+}
+
+class Rect extends Shape {
+    constructor(public w: number, public h: number) {
+        super();
+    }
+
+    area() {
+        return this.w * this.h;
+    }
+
+    name() {
+        return "rect";
+    }
+}
+
+function totalArea(shapes: Shape[]) {
+    let total = 0;
+    for (const s of shapes) {
+        total += s.area();
+    }
+
+    return total;
+}
+
+function main() {
+    const c = new Counter();
+    for (let i = 0; i < 10; i++) {
+        c.inc(2);
+    }
+
+    assert(c.value == 20, "counter");
+
+    const shapes: Shape[] = [new Shape(), new Square(3), new Rect(2, 5)];
+    assert(totalArea(shapes) == 19, "area");
+
+    assert(shapes[0].name() == "shape", "name shape");
+    assert(shapes[1].name() == "shape", "name square");
+    assert(shapes[2].name() == "rect", "name rect");
+
+    const sq: Square = new Square(4);
+    assert(sq.area() == 16, "square");
+
+    print("done.");
+}
@@ -0,0 +1,27 @@
+// base is created on stack (ts.New), subclass only in GC heap (typed GC allocation)
+class Animal {
+    sound() {
+        return "...";
+    }
+}
+
+class Dog extends Animal {
+    sound() {
+        return "woof";
+    }
+}
+
+function speak(a: Animal) {
+    return a.sound();
+}
+
+function main() {
+    const onStack = Animal();
+    assert(speak(onStack) == "...", "stack base");
+
+    const inHeap: Animal = new Dog();
+    assert(speak(inHeap) == "woof", "heap subclass");
+    assert(inHeap.sound() == "woof", "call through base reference");
+
+    print("done.");
+}
@@ -0,0 +1,49 @@
+// class instances are allocated with typed GC descriptors: pointer fields must be scanned
+class Item {
+    next: Item;
+    name: string;
+
+    constructor(public id: number) {
+        this.name = "item" + id;
+    }
+}
+
+class List {
+    head: Item;
+    count = 0;
+
+    add(id: number) {
+        const item = new Item(id);
+        item.next = this.head;
+        this.head = item;
+        this.count++;
+    }
+}
+
+// allocated by global constructor, descriptor must be ready before it
+const globalList = new List();
+
+function main() {
+    for (let i = 0; i < 100000; i++) {
+        globalList.add(i);
+
+        // garbage
+        const tmp = new Item(-i);
+        tmp.name = tmp.name + "!";
+    }
+
+    assert(globalList.count == 100000, "count");
+
+    let sum = 0;
+    let n = 0;
+    for (let item = globalList.head; item; item = item.next) {
+        sum += item.id;
+        n++;
+    }
+
+    assert(n == 100000, "length");
+    assert(sum == 4999950000, "sum");
+    assert(globalList.head.name == "item99999", "name");
+
+    print("done.");
+}
@@ -0,0 +1,95 @@
+class Vector {
+    constructor(public x: number, public y: number) {
+    }
+
+    add(other: Vector) {
+        return new Vector(this.x + other.x, this.y + other.y);
+    }
+
+    dot(other: Vector) {
+        return this.x * other.x + this.y * other.y;
+    }
+}
+
+class Node {
+    next: Node;
+    constructor(public value: number) {
+    }
+}
+
+// temporary instances do not leave the function
+function sumDots(count: number) {
+    let total = 0;
+    for (let i = 0; i < count; i++) {
+        const a = new Vector(i, 1);
+        const b = new Vector(2, i);
+        total += a.dot(b);
+    }
+
+    return total;
+}
+
+// instance is returned
+function makeVector(x: number) {
+    return new Vector(x, x);
+}
+
+// instances are linked to each other and kept after loop
+function makeList(count: number) {
+    let head: Node = null;
+    for (let i = 0; i < count; i++) {
+        const node = new Node(i);
+        node.next = head;
+        head = node;
+    }
+
+    return head;
+}
+
+// instance from previous iteration is kept in variable
+function checkPrevious(count: number) {
+    let prev: Vector = null;
+    let checked = 0;
+    for (let i = 0; i < count; i++) {
+        const current = new Vector(i, i);
+        if (prev) {
+            assert(prev != current, "distinct instances");
+            assert(prev.x == i - 1 && current.x == i, "previous value");
+            checked++;
+        }
+
+        prev = current;
+    }
+
+    return checked;
+}
+
+function main() {
+    assert(sumDots(4) == 12, "dots");
+
+    const v = makeVector(3).add(makeVector(4));
+    assert(v.x == 7 && v.y == 7, "add");
+
+    let sum = 0;
+    let count = 0;
+    for (let n = makeList(5); n; n = n.next) {
+        sum += n.value;
+        count++;
+    }
+
+    assert(sum == 10, "list sum");
+    assert(count == 5, "list count");
+
+    const vectors: Vector[] = [];
+    for (let i = 0; i < 3; i++) {
+        const item = new Vector(i, i);
+        vectors.push(item);
+    }
+
+    assert(vectors[0].x == 0 && vectors[2].x == 2, "array of instances");
+    assert(vectors[0] != vectors[1] && vectors[1] != vectors[2], "distinct instances in array");
+
+    assert(checkPrevious(4) == 3, "previous instances");
+
+    print("done.");
+}
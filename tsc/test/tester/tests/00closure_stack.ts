@@ -0,0 +1,57 @@
+// callbacks which do not leave the function keep captured variables in stack
+function sumWithForEach(values: number[]) {
+    let sum = 0;
+    values.forEach((v) => { sum += v; });
+    return sum;
+}
+
+function countPositive(values: number[]) {
+    let count = 0;
+    const check = (v: number) => {
+        if (v > 0) count++;
+    };
+
+    for (const v of values) {
+        check(v);
+    }
+
+    return count;
+}
+
+function allBelow(values: number[], limit: number) {
+    return values.every((v) => v < limit);
+}
+
+// closure is returned, captured variable must stay alive after function exit
+function makeCounter() {
+    let count = 0;
+    return () => ++count;
+}
+
+// closure is stored in array
+function makeAdders(count: number) {
+    const adders: ((v: number) => number)[] = [];
+    for (let i = 0; i < count; i++) {
+        const step = i;
+        adders.push((v: number) => v + step);
+    }
+
+    return adders;
+}
+
+function main() {
+    assert(sumWithForEach([1, 2, 3, 4]) == 10, "forEach");
+    assert(countPositive([1, -2, 3, -4, 5]) == 3, "local closure");
+    assert(allBelow([1, 2, 3], 4), "every");
+    assert(!allBelow([1, 2, 5], 4), "every false");
+
+    const counter = makeCounter();
+    counter();
+    counter();
+    assert(counter() == 3, "counter");
+
+    const adders = makeAdders(3);
+    assert(adders[0](10) == 10 && adders[2](10) == 12, "adders");
+
+    print("done.");
+}
@@ -0,0 +1,46 @@
+function test_arithmetic() {
+    assert(2 + 3 * 4 == 14, "arithmetic");
+    assert(10 / 4 == 2.5, "division");
+    assert(7 % 3 == 1, "remainder");
+    assert(2 ** 10 == 1024, "power");
+    assert(-(5) == -5, "negate");
+    assert(1 / 0 > 1e308, "infinity");
+}
+
+function test_logical() {
+    assert(!false, "not");
+    assert(1 < 2, "less");
+    assert(!(2 <= 1), "not less or equal");
+    const nan = 0 / 0;
+    assert(nan != nan, "nan");
+}
+
+function test_strings() {
+    const s = "abc" + "def";
+    assert(s == "abcdef", "concat");
+    assert(`${"x"}-${"y"}` == "x-y", "template");
+    assert("a" < "b", "compare");
+    assert("abc" != "abd", "not equals");
+}
+
+function test_typeof() {
+    const n = 10;
+    const b = true;
+    const s = "str";
+    assert(typeof n == "number", "typeof number");
+    assert(typeof b == "boolean", "typeof boolean");
+    assert(typeof s == "string", "typeof string");
+
+    let u: number | string = 1;
+    assert(typeof u == "number", "typeof union");
+    u = "one";
+    assert(typeof u == "string", "typeof union 2");
+}
+
+function main() {
+    test_arithmetic();
+    test_logical();
+    test_strings();
+    test_typeof();
+    print("done.");
+}
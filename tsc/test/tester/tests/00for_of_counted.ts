@@ -0,0 +1,51 @@
+function dot(a: number[], b: number[]) {
+    let sum = 0;
+    for (let i = 0; i < a.length; i++) {
+        sum += a[i] * b[i];
+    }
+
+    return sum;
+}
+
+function main() {
+    const a = [1, 2, 3, 4];
+    const b = [4, 3, 2, 1];
+    assert(dot(a, b) == 20, "dot");
+
+    // array is not changed in loop, length and data are loaded once
+    let total = 0;
+    for (const x of a) {
+        for (const y of b) {
+            total += x * y;
+        }
+    }
+
+    assert(total == 100, "nested");
+
+    // array is changed in loop, new elements are visited
+    const grow = [1, 2, 3];
+    let count = 0;
+    for (const v of grow) {
+        if (v < 3) {
+            grow.push(v + 10);
+        }
+
+        count++;
+    }
+
+    assert(count == 5, "grow");
+
+    // variable is reassigned in loop
+    let arr = [1, 2, 3, 4, 5];
+    let visited = 0;
+    for (let i = 0; i < arr.length; i++) {
+        visited++;
+        if (i == 1) {
+            arr = [1, 2];
+        }
+    }
+
+    assert(visited == 2, "reassigned");
+
+    print("done.");
+}
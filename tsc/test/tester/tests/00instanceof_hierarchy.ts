@@ -0,0 +1,52 @@
+class Shape {
+    area() { return 0; }
+}
+
+class Rect extends Shape {
+    area() { return 4; }
+}
+
+class Square extends Rect {
+    area() { return 1; }
+}
+
+class Circle extends Shape {
+    area() { return 3; }
+}
+
+function classify(s: Shape) {
+    if (s instanceof Square) return 3;
+    if (s instanceof Rect) return 2;
+    if (s instanceof Circle) return 1;
+    return 0;
+}
+
+function main() {
+    const shapes: Shape[] = [new Shape(), new Rect(), new Square(), new Circle()];
+    let sum = 0;
+    for (const s of shapes) {
+        sum += classify(s);
+    }
+
+    assert(sum == 6, "classify");
+
+    // upcast is known statically
+    const sq = new Square();
+    assert(sq instanceof Square, "same class");
+    assert(sq instanceof Rect, "base");
+    assert(sq instanceof Shape, "root");
+
+    let none: Square = null;
+    assert(!(none instanceof Shape), "null");
+
+    // downcast is checked in runtime
+    const s: Shape = sq;
+    assert(s instanceof Square, "downcast");
+    assert(!(s instanceof Circle), "sibling");
+
+    const r: Shape = new Rect();
+    assert(r instanceof Rect, "rect");
+    assert(!(r instanceof Square), "not derived");
+
+    print("done.");
+}
@@ -0,0 +1,68 @@
+function sum(a: number[]) {
+    let s: number = 0;
+    for (let i: number = 0; i < a.length; i++) {
+        s += a[i];
+    }
+
+    return s;
+}
+
+function sumOdd(a: number[]) {
+    let s: number = 0;
+    for (let i: number = 1; i < a.length; i += 2) {
+        s += a[i * 1];
+    }
+
+    return s;
+}
+
+function main() {
+    const a = [1, 2, 3, 4, 5, 6];
+    assert(sum(a) == 21, "sum");
+    assert(sumOdd(a) == 12, "odd");
+
+    // counter and remainder
+    let even: number = 0;
+    for (let i: number = 0; i < 10; i++) {
+        if (i % 2 == 0) {
+            even++;
+        }
+    }
+
+    assert(even == 5, "even");
+
+    // bit operations
+    let h: number = 7;
+    for (let i: number = 0; i < 4; i++) {
+        h = (h * 31 + i) | 0;
+    }
+
+    assert(h == 6465673, "hash");
+
+    // value escapes as number
+    let half: number = 5;
+    half--;
+    assert(half / 2 == 2, "half");
+    assert(half / 8 == 0.5, "fraction");
+
+    // not an integer: stays number
+    let f: number = 1;
+    f = f / 2;
+    assert(f == 0.5, "float");
+
+    // -0 is not an integer
+    let z: number = 0;
+    z = -z;
+    assert(1 / z < 0, "minus zero");
+
+    let zm: number = 0;
+    zm = zm * -1;
+    assert(1 / zm < 0, "minus zero mul");
+
+    // large values
+    let big: number = 2147483647;
+    big++;
+    assert(big == 2147483648, "over i32");
+
+    print("done.");
+}
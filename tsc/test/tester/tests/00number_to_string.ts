@@ -0,0 +1,26 @@
+function str(n: number) {
+    return "" + n;
+}
+
+function main() {
+    assert(str(0) == "0", "zero");
+    assert(str(-0) == "0", "minus zero");
+    assert(str(1) == "1", "one");
+    assert(str(-1.5) == "-1.5", "negative");
+    assert(str(1234567) == "1234567", "7 digits");
+    assert(str(0.1 + 0.2) == "0.30000000000000004", "round-trip");
+    assert(str(1 / 3) == "0.3333333333333333", "third");
+    assert(str(1e20) == "100000000000000000000", "1e20");
+    assert(str(1e21) == "1e+21", "1e21");
+    assert(str(0.000001) == "0.000001", "1e-6");
+    assert(str(1.5e-7) == "1.5e-7", "1.5e-7");
+    assert(str(1.7976931348623157e308) == "1.7976931348623157e+308", "max");
+    assert(str(5e-324) == "5e-324", "min");
+    assert(str(1 / 0) == "Infinity", "infinity");
+    assert(str(-1 / 0) == "-Infinity", "-infinity");
+
+    const i = 2147483647;
+    assert(i.toString() == "2147483647", "int");
+
+    print("done.");
+}
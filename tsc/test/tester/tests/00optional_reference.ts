@@ -0,0 +1,53 @@
+class Node {
+    next?: Node;
+    label?: string;
+
+    constructor(public value: number) {}
+}
+
+function find(head: Node | undefined, value: number): Node | undefined {
+    for (let n = head; n !== undefined; n = n.next) {
+        if (n.value == value) return n;
+    }
+
+    return undefined;
+}
+
+function describe(label?: string) {
+    return label || "<none>";
+}
+
+function main() {
+    // linked list over optional class fields
+    let head: Node | undefined = undefined;
+    for (let i = 0; i < 10; i++) {
+        const node = new Node(i);
+        node.next = head;
+        head = node;
+    }
+
+    assert(head !== undefined, "head");
+    assert(find(head, 3)?.value == 3, "found");
+    assert(find(head, 42) === undefined, "not found");
+
+    let count = 0;
+    for (let n = head; n; n = n.next) count++;
+    assert(count == 10, "count");
+
+    // optional strings
+    const n = new Node(1);
+    assert(n.label === undefined, "no label");
+    assert(describe(n.label) == "<none>", "describe none");
+    n.label = "first";
+    assert(n.label !== undefined, "label");
+    assert(describe(n.label) == "first", "describe");
+    assert(describe() == "<none>", "no argument");
+
+    let s: string | undefined;
+    assert(typeof s == "undefined", "typeof undefined");
+    s = "";
+    assert(s !== undefined, "empty string has value");
+    assert(typeof s == "string", "typeof string");
+
+    print("done.");
+}
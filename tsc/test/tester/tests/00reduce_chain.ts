@@ -0,0 +1,26 @@
+function main() {
+    const arr = [1, 2, 3, 4, 5];
+
+    // map, filter and reduce are fused into one loop
+    const sumOfEvenSquares = arr.map(x => x * x).filter(x => x % 2 == 0).reduce((s, v) => s + v, 0);
+    assert(sumOfEvenSquares == 20, "chain");
+
+    const count = arr.filter(x => x > 2).reduce((s: number, v) => s + 1, 0);
+    assert(count == 3, "filter count");
+
+    assert(arr.map(x => x + 10).every(x => x > 10), "map every");
+    assert(arr.map(x => x * 2).some(x => x == 8), "map some");
+    assert(!arr.filter(x => x > 3).some(x => x == 1), "filter some");
+
+    let total = 0;
+    arr.filter(x => x % 2 == 1).forEach(v => {
+        total += v;
+    });
+    assert(total == 9, "filter forEach");
+
+    // the same parameter name in all stages
+    const same = arr.map(x => x + 1).filter(x => x > 3).reduce((x, v) => x + v, 100);
+    assert(same == 115, "same names");
+
+    print("done.");
+}
@@ -0,0 +1,79 @@
+function test_loop_invariant() {
+    const a = 3;
+    const b = 4;
+    let sum = 0;
+    for (let i = 0; i < 10; i++) {
+        // invariant part can be hoisted, 'i' part can't
+        sum += a * b + i;
+    }
+
+    assert(sum == 165, "invariant");
+}
+
+function test_loads_after_store() {
+    let arr = [1, 2, 3];
+    let total = 0;
+    for (let i = 0; i < 3; i++) {
+        // loads must not be merged or hoisted over push
+        total += arr.length;
+        arr.push(i);
+    }
+
+    assert(total == 12, "length after push");
+    assert(arr.length == 6, "length");
+}
+
+function test_increment_in_loop() {
+    let i = 0;
+    let j = 0;
+    while (i < 5) {
+        j = i++;
+    }
+
+    assert(i == 5, "postfix");
+    assert(j == 4, "value before postfix");
+}
+
+function test_div_in_guarded_loop(d: number) {
+    let n = 0;
+    let r = 0;
+    while (n < d) {
+        r = 10 / d;
+        n++;
+    }
+
+    return r;
+}
+
+function test_strings() {
+    const s = "abc";
+    let count = 0;
+    for (let i = 0; i < 3; i++) {
+        if (s + "d" == "abcd") count++;
+        if (typeof s == "string") count++;
+    }
+
+    assert(count == 6, "strings");
+}
+
+function test_string_in_guarded_loop(s: string, n: number) {
+    let total = 0;
+    for (let i = 0; i < n; i++) {
+        // string can be null when loop is not executed, length must not be hoisted
+        total += s.length + parseInt(s);
+    }
+
+    return total;
+}
+
+function main() {
+    test_loop_invariant();
+    test_loads_after_store();
+    test_increment_in_loop();
+    assert(test_div_in_guarded_loop(0) == 0, "division in loop which is not executed");
+    assert(test_div_in_guarded_loop(2) == 5, "division in loop");
+    test_strings();
+    assert(test_string_in_guarded_loop(null, 0) == 0, "null string in loop which is not executed");
+    assert(test_string_in_guarded_loop("12", 2) == 28, "string in loop");
+    print("done.");
+}
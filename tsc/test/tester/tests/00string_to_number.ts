@@ -0,0 +1,38 @@
+function isnan(x: number) {
+    return x != x;
+}
+
+function toNumber(s: string) {
+    return <number>s;
+}
+
+function main() {
+    // parseFloat: longest decimal prefix after whitespaces
+    assert(parseFloat("3.14") == 3.14, "float");
+    assert(parseFloat("  -2.5e3px") == -2500, "prefix");
+    assert(parseFloat(".5") == 0.5, "fraction");
+    assert(parseFloat("1.5e") == 1.5, "incomplete exponent");
+    assert(parseFloat("0.1") == 0.1, "round");
+    assert(parseFloat("Infinity") == 1 / 0, "infinity");
+    assert(parseFloat("1e400") == 1 / 0, "overflow");
+    assert(parseFloat("0x10") == 0, "no hex");
+    assert(isnan(parseFloat("foobar")), "nan");
+
+    // parseInt: digits in radix, 0x prefix
+    assert(parseInt("42px") == 42, "int prefix");
+    assert(parseInt("  -123") == -123, "negative");
+    assert(parseInt("0x1F") == 31, "hex");
+    assert(parseInt("101", 2) == 5, "binary");
+    assert(parseInt("z", 36) == 35, "radix 36");
+    assert(parseInt("3.9") == 3, "stops at point");
+
+    // implicit conversion: whole string
+    assert(toNumber(" 12 ") == 12, "trim");
+    assert(toNumber("") == 0, "empty");
+    assert(toNumber("0x10") == 16, "hex literal");
+    assert(toNumber("0b101") == 5, "binary literal");
+    assert(toNumber("1e3") == 1000, "exponent");
+    assert(isnan(toNumber("12px")), "junk");
+
+    print("done.");
+}
@@ -0,0 +1,67 @@
+function repeat(piece: string, count: number) {
+    let s = "";
+    for (let i = 0; i < count; i++) {
+        s += piece;
+    }
+
+    return s;
+}
+
+function report(rows: number) {
+    let out = "";
+    for (let i = 0; i < rows; i++) {
+        out = out + "row " + i + "\n";
+    }
+
+    return out;
+}
+
+function main() {
+    const r = repeat("ab", 1000);
+    assert(r.length == 2000, "repeat length");
+    assert(repeat("x", 3) == "xxx", "repeat");
+    assert(repeat("x", 0) == "", "repeat none");
+
+    assert(report(2) == "row 0\nrow 1\n", "report");
+    assert(report(10000).length > 80000, "report length");
+
+    // value read after loop is not changed by next run of loop
+    const lines: string[] = [];
+    let line = "";
+    for (let j = 0; j < 3; j++) {
+        line = "";
+        for (let i = 0; i < 3; i++) {
+            line += j;
+        }
+
+        lines.push(line);
+    }
+
+    assert(lines[0] == "000", "line 0");
+    assert(lines[1] == "111", "line 1");
+    assert(lines[2] == "222", "line 2");
+
+    // variable used in loop not only by accumulation
+    let seen = "";
+    let copy = "";
+    for (let i = 0; i < 3; i++) {
+        seen += i;
+        copy = seen;
+    }
+
+    seen += "!";
+    assert(copy == "012", "copy");
+    assert(seen == "012!", "seen");
+
+    // while loop
+    let w = "";
+    let k = 0;
+    while (k < 5) {
+        w += "w";
+        k++;
+    }
+
+    assert(w == "wwwww", "while");
+
+    print("done.");
+}
@@ -0,0 +1,70 @@
+class Event {
+    constructor(public type: string) {}
+}
+
+function dispatch(e: Event) {
+    switch (e.type) {
+        case "click":
+            return 1;
+        case "close":
+            return 2;
+        case "key":
+            return 3;
+    }
+
+    return 0;
+}
+
+function join(a: string, b: string) {
+    return a + b;
+}
+
+function build(parts: string[]) {
+    let s = "";
+    for (const part of parts) {
+        s += part;
+    }
+
+    return s;
+}
+
+function main() {
+    // literals and tags from literals
+    assert(dispatch(new Event("click")) == 1, "click");
+    assert(dispatch(new Event("close")) == 2, "close");
+    assert(dispatch(new Event("key")) == 3, "key");
+    assert(dispatch(new Event("move")) == 0, "other");
+
+    // built strings: equal bodies in different buffers
+    const c = join("cl", "ick");
+    assert(c == "click", "equal body");
+    assert(!(c != "click"), "not not equal");
+    assert(c != "clack", "same first char");
+    assert(c != "slick", "different first char");
+    assert(dispatch(new Event(c)) == 1, "built tag");
+
+    // ordering
+    assert("abc" < "abd", "less");
+    assert("b" > "abc", "greater");
+    assert(c <= "click" && c >= "click", "equal ordering");
+    assert("" < "a", "empty");
+
+    // both sides built at runtime
+    const d = build(["c", "li", "ck"]);
+    const e = build(["c", "la", "ck"]);
+    const n = (12345).toString();
+    assert(c == d, "built equal");
+    assert(!(c != d), "built not not equal");
+    assert(c != e, "built not equal");
+    assert(e < c && c > e, "built ordering");
+    assert(c <= d && c >= d, "built equal ordering");
+    assert(!(c < d) && !(c > d), "built not strictly ordered");
+    assert(n == join("123", "45"), "number to string");
+    assert(n < join("123", "46"), "number to string ordering");
+
+    // boolean to string
+    const t = true;
+    assert(`${t}` == "true", "true");
+
+    print("done.");
+}
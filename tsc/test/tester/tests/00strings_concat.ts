@@ -0,0 +1,33 @@
+function join3(a: string, b: string, c: string) {
+    return a + "-" + b + "-" + c;
+}
+
+function main() {
+    // literal length is known at compile time
+    assert("hello".length == 5, "literal length");
+    assert("".length == 0, "empty length");
+
+    const s = join3("one", "two", "three");
+    assert(s == "one-two-three", "concat parts");
+    assert(s.length == 13, "concat length");
+
+    // empty parts
+    const e = join3("", "", "");
+    assert(e == "--", "empty parts");
+    assert(e.length == 2, "empty parts length");
+
+    // growing string
+    let acc = "";
+    for (let i = 0; i < 20; i++) {
+        acc = acc + i;
+    }
+
+    assert(acc == "012345678910111213141516171819", "accumulate");
+    assert(acc.length == 30, "accumulate length");
+
+    // result is terminated
+    const t = "a" + "b" + s;
+    assert(t == "abone-two-three", "terminated");
+
+    print("done.");
+}
@@ -0,0 +1,112 @@
+enum Color {
+    Red,
+    Green = 10,
+    Blue = -1
+}
+
+function byInt(a: number) {
+    let r = 0;
+    switch (a) {
+        case 1:
+            r += 1;
+        case 2:
+            r += 2;
+            break;
+        case -3:
+            r = 3;
+            break;
+        case 100:
+            r = 100;
+            break;
+        case 1:
+            r = 1000;
+            break;
+        default:
+            r = -1;
+    }
+
+    return r;
+}
+
+function defaultFirst(a: number) {
+    let r = 0;
+    switch (a) {
+        default:
+            r += 10;
+        case 1:
+            r += 1;
+            break;
+        case 2:
+            r = 2;
+            break;
+        case 3:
+            r = 3;
+            break;
+    }
+
+    return r;
+}
+
+function byEnum(c: Color) {
+    switch (c) {
+        case Color.Red:
+            return "red";
+        case Color.Green:
+            return "green";
+        case Color.Blue:
+            return "blue";
+    }
+
+    return "none";
+}
+
+function byString(s: string) {
+    switch (s) {
+        case "":
+            return 0;
+        case "a":
+            return 1;
+        case "ab":
+            return 2;
+        case "abc":
+            return 3;
+        case "abd":
+            return 4;
+        case "bbc":
+            return 5;
+        case "abc":
+            return 6;
+        default:
+            return -1;
+    }
+}
+
+function main() {
+    assert(byInt(1) == 3, "int fall through");
+    assert(byInt(2) == 2, "int 2");
+    assert(byInt(-3) == 3, "int -3");
+    assert(byInt(100) == 100, "int 100");
+    assert(byInt(7) == -1, "int default");
+
+    assert(defaultFirst(1) == 1, "default first 1");
+    assert(defaultFirst(3) == 3, "default first 3");
+    assert(defaultFirst(5) == 11, "default first fall through");
+
+    assert(byEnum(Color.Red) == "red", "enum red");
+    assert(byEnum(Color.Green) == "green", "enum green");
+    assert(byEnum(Color.Blue) == "blue", "enum blue");
+
+    assert(byString("") == 0, "empty string");
+    assert(byString("a") == 1, "a");
+    assert(byString("ab") == 2, "ab");
+    assert(byString("abc") == 3, "abc");
+    assert(byString("abd") == 4, "abd");
+    assert(byString("bbc") == 5, "bbc");
+    assert(byString("abe") == -1, "miss same key");
+    assert(byString("xyz") == -1, "miss");
+
+    let n: string = null;
+    assert(byString(n) == -1, "null string");
+
+    print("done.");
+}
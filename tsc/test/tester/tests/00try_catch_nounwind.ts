@@ -0,0 +1,45 @@
+function square(x: number) {
+    return x * x;
+}
+
+function fact(n: number): number {
+    return n <= 1 ? 1 : n * fact(n - 1);
+}
+
+function check(x: number) {
+    if (x > 100) {
+        throw "too big";
+    }
+
+    return x;
+}
+
+function callsThrowing(x: number) {
+    return check(x) + 1;
+}
+
+function main() {
+    let r = 0;
+
+    // callees can't throw, invokes are replaced with calls
+    try {
+        r = square(3) + fact(4);
+    } catch (e: string) {
+        r = -1;
+    }
+
+    assert(r == 33, "nounwind");
+
+    // callees can throw, landing pad is kept
+    try {
+        r = callsThrowing(10);
+        r = callsThrowing(1000);
+    } catch (e: string) {
+        print(e);
+        r = -r;
+    }
+
+    assert(r == -11, "unwind");
+
+    print("done.");
+}
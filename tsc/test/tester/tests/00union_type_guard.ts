@@ -0,0 +1,53 @@
+function sumNumbers(values: (number | string | boolean)[]) {
+    let sum = 0;
+    for (const v of values) {
+        if (typeof v === "number") {
+            sum += v;
+        }
+    }
+
+    return sum;
+}
+
+function countStrings(values: (number | string | boolean)[]) {
+    let count = 0;
+    for (const v of values) {
+        if (typeof v !== "string") {
+            continue;
+        }
+
+        count++;
+    }
+
+    return count;
+}
+
+function kind(a: any) {
+    if (typeof a == "number") return 1;
+    if (typeof a == "string") return 2;
+    if (typeof a == "boolean") return 3;
+    return 0;
+}
+
+function join(a: string, b: string) {
+    return a + b;
+}
+
+function main() {
+    const values: (number | string | boolean)[] = [1, "a", true, 2, "bc", false, 3];
+    assert(sumNumbers(values) == 6, "numbers");
+    assert(countStrings(values) == 2, "strings");
+
+    assert(kind(1) == 1, "any number");
+    assert(kind("s") == 2, "any string");
+    assert(kind(true) == 3, "any boolean");
+
+    // literals compared inline with built strings
+    const n = join("num", "ber");
+    assert(n == "number", "built equal");
+    assert(n != "numbers", "longer literal");
+    assert(n != "num", "shorter literal");
+    assert("null" != n, "same first char");
+
+    print("done.");
+}
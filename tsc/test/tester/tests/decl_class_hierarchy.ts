@@ -0,0 +1,20 @@
+export class Animal
+{
+	speak()
+	{
+		return 1;
+	}
+}
+
+export class Dog extends Animal
+{
+	speak()
+	{
+		return 2;
+	}
+}
+
+export function makeAnimal(): Animal
+{
+	return new Dog();
+}
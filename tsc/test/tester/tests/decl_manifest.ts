@@ -0,0 +1,11 @@
+export enum Color { Red = 1, Green = 2, Blue = 4 };
+export type Size = { width: number; height: number; };
+export function area(s: Size): number {
+	return s.width * s.height;
+}
+export function mix(a: Color, b: Color): number {
+	return a | b;
+}
+export function label(name: string, count: number): string {
+	return name + ":" + count;
+}
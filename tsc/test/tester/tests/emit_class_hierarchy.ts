@@ -0,0 +1,24 @@
+import "./decl_class_hierarchy";
+
+// the only subclass instantiated here, but library creates its own subclasses
+class Cat extends Animal
+{
+	speak()
+	{
+		return 3;
+	}
+}
+
+function speakOf(a: Animal)
+{
+	return a.speak();
+}
+
+function main()
+{
+	const c = new Cat();
+	assert(speakOf(c) == 3, "local subclass");
+	assert(speakOf(makeAnimal()) == 2, "subclass from shared library");
+
+	print("done.");
+}
@@ -0,0 +1,11 @@
+import "./decl_manifest";
+
+function main()
+{
+	// declarations of all kinds are read back from binary manifest of library
+	assert(area({ width: 2, height: 3 }) == 6, "type alias");
+	assert(mix(Color.Red, Color.Blue) == 5, "enum");
+	assert(label("items", 3) == "items:3", "function");
+
+	print("done.");
+}
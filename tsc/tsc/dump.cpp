@@ -15,6 +15,7 @@
 #include "llvm/Support/ToolOutputFile.h"
 
 #include "TypeScript/TypeScriptCompiler/Defines.h"
+#include "TypeScript/MemoryStats.h"
 
 #define DEBUG_TYPE "tsc"
 
@@ -52,6 +53,7 @@ int dumpLLVMIR(mlir::ModuleOp module, CompileOptions &compileOptions)
 
     // Convert the module to LLVM IR in a new LLVM IR context.
     llvm::LLVMContext llvmContext;
+    typescript::MemoryStatsScope memScope("LLVM module");
     auto llvmModule = mlir::translateModuleToLLVMIR(module, llvmContext);
     if (!llvmModule)
     {
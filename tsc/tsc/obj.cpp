@@ -21,9 +21,11 @@
 #include "llvm/Support/PrettyStackTrace.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/WithColor.h"
+#include "llvm/Support/TimeProfiler.h"
 
 #include "TypeScript/TypeScriptCompiler/Defines.h"
 #include "TypeScript/DataStructs.h"
+#include "TypeScript/MemoryStats.h"
 
 #define DEBUG_TYPE "tsc"
 
@@ -253,7 +255,13 @@ int dumpObjOrAssembly(int argc, char **argv, enum Action emitAction, std::string
 
     // Convert the module to LLVM IR in a new LLVM IR context.
     llvm::LLVMContext llvmContext;
-    auto llvmModule = mlir::translateModuleToLLVMIR(module, llvmContext);
+    std::unique_ptr<llvm::Module> llvmModule;
+    {
+        llvm::TimeTraceScope timeScope("Translate to LLVM IR");
+        typescript::MemoryStatsScope memScope("LLVM module");
+        llvmModule = mlir::translateModuleToLLVMIR(module, llvmContext);
+    }
+
     if (!llvmModule)
     {
         llvm::WithColor::error(llvm::errs(), "tsc") << "Failed to emit LLVM IR\n";
@@ -274,10 +282,13 @@ int dumpObjOrAssembly(int argc, char **argv, enum Action emitAction, std::string
     }
 
     auto optPipeline = getTransformer(enableOpt, optLevel, sizeLevel, compileOptions);
-    if (auto err = optPipeline(llvmModule.get()))
     {
-        llvm::WithColor::error(llvm::errs(), "tsc") << "Failed to optimize LLVM IR " << err << "\n";
-        return -1;
+        typescript::MemoryStatsScope memScope("LLVM module (optimization)");
+        if (auto err = optPipeline(llvmModule.get()))
+        {
+            llvm::WithColor::error(llvm::errs(), "tsc") << "Failed to optimize LLVM IR " << err << "\n";
+            return -1;
+        }
     }
 
     //
@@ -359,7 +370,11 @@ int dumpObjOrAssembly(int argc, char **argv, enum Action emitAction, std::string
         // Before executing passes, print the final values of the LLVM options.
         //llvm::cl::PrintOptionValues();
 
-        PM.run(*llvmModule.get());
+        {
+            llvm::TimeTraceScope timeScope("Emit Object", outputFile);
+            typescript::MemoryStatsScope memScope("Codegen");
+            PM.run(*llvmModule.get());
+        }
 
         auto HasError = ((const LLCDiagnosticHandler *)(Context.getDiagHandlerPtr()))->HasError;
         if (*HasError)
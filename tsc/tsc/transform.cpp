@@ -34,8 +34,10 @@
 #include "llvm/Analysis/CGSCCPassManager.h"
 #include "llvm/Passes/OptimizationLevel.h"
 #include "llvm/Passes/PassBuilder.h"
+#include "llvm/Passes/StandardInstrumentations.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/TimeProfiler.h"
 
 #ifdef GC_ENABLE
 #include "llvm/IR/GCStrategy.h"
@@ -64,6 +66,37 @@ extern cl::opt<int> sizeLevel;
 extern cl::opt<bool> disableGC;
 extern cl::opt<bool> disableWarnings;
 
+// records MLIR passes in time profiler (-time-trace)
+class TimeTracePassInstrumentation : public mlir::PassInstrumentation
+{
+public:
+    void runBeforePass(mlir::Pass *pass, mlir::Operation *op) override
+    {
+        llvm::timeTraceProfilerBegin(pass->getName(), [&]() { return getOpDetail(op); });
+    }
+
+    void runAfterPass(mlir::Pass *pass, mlir::Operation *op) override
+    {
+        llvm::timeTraceProfilerEnd();
+    }
+
+    void runAfterPassFailed(mlir::Pass *pass, mlir::Operation *op) override
+    {
+        llvm::timeTraceProfilerEnd();
+    }
+
+private:
+    static std::string getOpDetail(mlir::Operation *op)
+    {
+        if (auto symName = op->getAttrOfType<mlir::StringAttr>(mlir::SymbolTable::getSymbolAttrName()))
+        {
+            return symName.getValue().str();
+        }
+
+        return op->getName().getStringRef().str();
+    }
+};
+
 int runMLIRPasses(mlir::MLIRContext &context, llvm::SourceMgr &sourceMgr, mlir::OwningOpRef<mlir::ModuleOp> &module, CompileOptions &compileOptions)
 {
     mlir::SmallVector<std::unique_ptr<mlir::Diagnostic>> postponedMessages;
@@ -73,6 +106,10 @@ int runMLIRPasses(mlir::MLIRContext &context, llvm::SourceMgr &sourceMgr, mlir::
     mlir::PassManager pm(&context);
     // Apply any generic pass manager command line options and run the pipeline.
     applyPassManagerCLOptions(pm);
+    if (llvm::timeTraceProfilerEnabled())
+    {
+        pm.addInstrumentation(std::make_unique<TimeTracePassInstrumentation>());
+    }
 
     // Check to see what granularity of MLIR we are compiling to.
     bool isLoweringToAffine = emitAction >= Action::DumpMLIRAffine;
@@ -82,6 +119,31 @@ int runMLIRPasses(mlir::MLIRContext &context, llvm::SourceMgr &sourceMgr, mlir::
     {
         pm.addPass(mlir::createCanonicalizerPass());
 
+#ifdef ENABLE_OPT_PASSES
+        if (enableOpt)
+        {
+            // all classes are known only when whole program is compiled
+            if (emitAction == Action::BuildExe || emitAction == Action::RunJIT)
+            {
+                pm.addPass(mlir::typescript::createDevirtualizePass());
+            }
+
+            // before captures are lowered, calls of known closures are direct already (canonicalizer)
+            pm.addPass(mlir::typescript::createClosureEscapePass());
+
+            // before loops are lowered, strings accumulated in loops are still loads and stores of variables
+            pm.addPass(mlir::typescript::createStringBuilderPass());
+
+            // TypeScript ops declare memory effects, so redundancy elimination and hoisting can run before lowering
+            mlir::OpPassManager &tsOptPM = pm.nest<mlir::typescript::FuncOp>();
+            tsOptPM.addPass(mlir::createCSEPass());
+            tsOptPM.addPass(mlir::createLoopInvariantCodeMotionPass());
+
+            // before ++/-- and loops are lowered, variables are still loaded and stored by ts ops
+            pm.addPass(mlir::typescript::createIntegerRangePass());
+        }
+#endif
+
 #ifdef ENABLE_ASYNC
         pm.addPass(mlir::createAsyncToAsyncRuntimePass());
 #endif
@@ -118,6 +180,8 @@ int runMLIRPasses(mlir::MLIRContext &context, llvm::SourceMgr &sourceMgr, mlir::
             pm.addPass(mlir::createStripDebugInfoPass());
             pm.addPass(mlir::createInlinerPass());
             pm.addPass(mlir::createSCCPPass());
+            // after inlining, so allocations from <Class>..new are visible at call site
+            pm.addPass(mlir::typescript::createEscapeAnalysisPass());
             pm.addPass(mlir::createSymbolDCEPass());
         }
 #endif
@@ -144,6 +208,14 @@ int runMLIRPasses(mlir::MLIRContext &context, llvm::SourceMgr &sourceMgr, mlir::
         {
             pm.addPass(mlir::typescript::createGCPass(compileOptions));
         }
+
+#ifdef ENABLE_OPT_PASSES
+        if (enableOpt)
+        {
+            // after GC pass, names of runtime functions are final
+            pm.addPass(mlir::typescript::createFunctionAttrsPass());
+        }
+#endif
     }
 
     auto result = 0;
@@ -217,12 +289,22 @@ std::function<llvm::Error(llvm::Module *)> makeCustomPassesWithOptimizingTransfo
                 llvm::inconvertibleErrorCode());
         }
 
+        llvm::TimeTraceScope timeScope("Optimize LLVM Module", m->getName());
+
         llvm::LoopAnalysisManager lam;
         llvm::FunctionAnalysisManager fam;
         llvm::CGSCCAnalysisManager cgam;
         llvm::ModuleAnalysisManager mam;
 
-        llvm::PassBuilder pb(targetMachine);
+        // StandardInstrumentations registers per pass time profiling when -time-trace is used
+        llvm::PassInstrumentationCallbacks pic;
+        llvm::StandardInstrumentations si(m->getContext(), false);
+        if (llvm::timeTraceProfilerEnabled())
+        {
+            si.registerCallbacks(pic, &mam);
+        }
+
+        llvm::PassBuilder pb(targetMachine, llvm::PipelineTuningOptions(), std::nullopt, &pic);
 
         pb.registerModuleAnalyses(mam);
         pb.registerCGSCCAnalyses(cgam);
@@ -16,6 +16,7 @@
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/CodeGen/CommandFlags.h"
 
 // Obj/ASM
@@ -27,6 +28,7 @@
 
 #include "TypeScript/TypeScriptCompiler/Defines.h"
 #include "TypeScript/DataStructs.h"
+#include "TypeScript/MemoryStats.h"
 
 #define DEBUG_TYPE "tsc"
 
@@ -108,6 +110,10 @@ cl::opt<std::string> tsclibpath("tsc-lib-path", cl::desc("TypeScript Compiler Ru
 cl::opt<std::string> emsdksysrootpath("emsdk-sysroot-path", cl::desc("TypeScript Compiler Runtime library path. Should point to dir '<...>/emsdk/upstream/emscripten/cache/sysroot' or EMSDK_SYSROOT_PATH environmental variable. (used when '-mtriple=wasm32-pc-emscripten')"), cl::value_desc("emsdksysrootpath"), cl::cat(TypeScriptCompilerBuildCategory));
 cl::list<std::string> libs{"lib", cl::desc("Libraries to link statically. (used in --emit=exe)"), cl::ZeroOrMore, cl::MiscFlags::CommaSeparated, cl::cat(TypeScriptCompilerBuildCategory)};
 
+cl::opt<std::string> timeTraceFile("time-trace", cl::desc("Record time spent in each compiler phase (parsing, MLIRGen, passes, LLVM optimizations, object emission, linking) in Chrome trace format into <filename>"), cl::value_desc("filename"), cl::cat(TypeScriptCompilerCategory));
+cl::opt<bool> printMemoryStats("print-memory-stats", cl::desc("Print peak memory usage, memory allocated in each compiler phase (AST, MLIR context, LLVM module, codegen) and amount of MLIR operations after each lowering stage"), cl::init(false), cl::cat(TypeScriptCompilerCategory));
+cl::opt<unsigned> timeTraceGranularity("time-trace-granularity", cl::desc("Minimum time granularity (in microseconds) traced by time profiler"), cl::init(500), cl::cat(TypeScriptCompilerCategory));
+
 cl::opt<bool> noDefaultLib("no-default-lib", cl::desc("Disable loading default lib"), cl::init(false), cl::cat(TypeScriptCompilerCategory));
 cl::opt<bool> enableBuiltins("builtins", cl::desc("Builtin functionality (needed if Default lib is not provided)"), cl::init(true), cl::cat(TypeScriptCompilerCategory));
 
@@ -125,6 +131,55 @@ void HideUnrelatedOptionsButVisibleForHidden(cl::SubCommand &Sub) {
     }
 }
 
+class TimeTraceGuard
+{
+    bool enabled;
+
+public:
+    TimeTraceGuard(const char *argv0) : enabled(!timeTraceFile.empty())
+    {
+        if (enabled)
+        {
+            llvm::timeTraceProfilerInitialize(timeTraceGranularity, argv0);
+        }
+    }
+
+    ~TimeTraceGuard()
+    {
+        if (!enabled)
+        {
+            return;
+        }
+
+        if (auto err = llvm::timeTraceProfilerWrite(timeTraceFile, inputFilename))
+        {
+            llvm::WithColor::error(llvm::errs(), "tsc") << "can't write time trace: " << llvm::toString(std::move(err)) << "\n";
+        }
+
+        llvm::timeTraceProfilerCleanup();
+    }
+};
+
+class MemoryStatsGuard
+{
+  public:
+    MemoryStatsGuard()
+    {
+        if (printMemoryStats)
+        {
+            typescript::MemoryStats::enable();
+        }
+    }
+
+    ~MemoryStatsGuard()
+    {
+        if (printMemoryStats)
+        {
+            typescript::MemoryStats::print(llvm::errs());
+        }
+    }
+};
+
 std::string GetTemporaryPath(llvm::StringRef Prefix, llvm::StringRef Suffix)
 {
     llvm::SmallString<256> Path;
@@ -190,6 +245,10 @@ int main(int argc, char **argv)
 
     cl::ParseCommandLineOptions(argc, argv, "TypeScript native compiler\n");
 
+    TimeTraceGuard timeTraceGuard(argv[0]);
+    llvm::TimeTraceScope timeScope("Total", inputFilename);
+    MemoryStatsGuard memoryStatsGuard;
+
     if (emitAction == Action::DumpAST)
     {
         return dumpAST();
@@ -213,6 +272,12 @@ int main(int argc, char **argv)
     mlirContext.getOrLoadDialect<mlir::async::AsyncDialect>();
 #endif
 
+    if (llvm::timeTraceProfilerEnabled())
+    {
+        // time profiler records only events of the thread it was initialized in
+        mlirContext.disableMultithreading();
+    }
+
 #ifdef NDEBUG
     mlirContext.printOpOnDiagnostic(false);
 #else 
@@ -227,14 +292,23 @@ int main(int argc, char **argv)
 
     llvm::SourceMgr sourceMgr;
     mlir::OwningOpRef<mlir::ModuleOp> module;
-    if (int error = compileTypeScriptFileIntoMLIR(mlirContext, sourceMgr, module, compileOptions))
     {
-        return error;
+        llvm::TimeTraceScope timeScope("MLIRGen");
+        if (int error = compileTypeScriptFileIntoMLIR(mlirContext, sourceMgr, module, compileOptions))
+        {
+            return error;
+        }
+
+        typescript::MemoryStats::recordOpCount("after MLIRGen", module->getOperation());
     }
 
-    if (int error = runMLIRPasses(mlirContext, sourceMgr, module, compileOptions))
     {
-        return error;
+        llvm::TimeTraceScope timeScope("MLIR Passes");
+        typescript::MemoryStatsScope memScope("MLIR passes");
+        if (int error = runMLIRPasses(mlirContext, sourceMgr, module, compileOptions))
+        {
+            return error;
+        }
     }
 
     // If we aren't exporting to non-mlir, then we are done.
@@ -268,12 +342,15 @@ int main(int argc, char **argv)
             return result;
         }
 
+        llvm::TimeTraceScope timeScope("Link", tempOutputFile);
         return buildExe(argc, argv, tempOutputFile, compileOptions);
     }
 
     // Otherwise, we must be running the jit.
     if (emitAction == Action::RunJIT)
     {
+        llvm::TimeTraceScope timeScope("JIT");
+        typescript::MemoryStatsScope memScope("JIT (LLVM module, codegen)");
         return runJit(argc, argv, *module, compileOptions);
     }
 